@@ -0,0 +1,104 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "s21_matrix_oop.h"
+#include "s21_tiled_matrix.h"
+#include "s21_tuning.h"
+
+namespace {
+template <class F>
+double time_ms(F&& body, int repeats) {
+  double best = 0.0;
+  for (int r = 0; r < repeats; ++r) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (r == 0 || elapsed.count() < best) {
+      best = elapsed.count();
+    }
+  }
+  return best;
+}
+
+S21Matrix make_matrix(int n) {
+  S21Matrix m(n, n);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      m(i, j) = ((i * 31 + j * 17) % 101) / 101.0;
+    }
+  }
+  return m;
+}
+
+void report(const std::string& name, int n, double ms) {
+  std::cout << std::left << std::setw(28) << name << std::right
+            << std::setw(6) << n << std::setw(12) << std::fixed
+            << std::setprecision(2) << ms << " ms" << std::endl;
+}
+
+// --tune: подобрать параметры на этой машине и сохранить профиль
+int tune() {
+  const S21TuningProfile profile = S21Tuning::autotune(512);
+  S21Tuning::save(S21Tuning::default_path());
+  std::cout << "gemm_block " << profile.gemm_block << "\n"
+            << "gemm_grain " << profile.gemm_grain << "\n"
+            << "gemm_parallel_flops " << profile.gemm_parallel_flops << "\n"
+            << "transpose_block " << profile.transpose_block << "\n"
+            << "reduce_parallel_size " << profile.reduce_parallel_size
+            << "\n"
+            << "lu_parallel_work " << profile.lu_parallel_work << "\n"
+            << "saved to " << S21Tuning::default_path() << std::endl;
+  return 0;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc > 1 && std::string(argv[1]) == "--tune") {
+    return tune();
+  }
+  for (int n : {256, 512, 1024}) {
+    const int repeats = n < 1024 ? 5 : 2;
+    S21Matrix a = make_matrix(n);
+    S21Matrix b = make_matrix(n);
+    S21TiledMatrix a_blocked(a, 64, S21Layout::kBlocked);
+    S21TiledMatrix b_blocked(b, 64, S21Layout::kBlocked);
+    S21TiledMatrix a_morton(a, 64, S21Layout::kMorton);
+    S21TiledMatrix b_morton(b, 64, S21Layout::kMorton);
+    double sink = 0.0;
+    report("mul_matrix row-major", n,
+           time_ms([&] { sink += (a * b)(0, 0); }, repeats));
+    report("mul_matrix tiled", n, time_ms([&] {
+             sink += a_blocked.mul_matrix(b_blocked)(0, 0);
+           }, repeats));
+    report("mul_matrix morton", n, time_ms([&] {
+             sink += a_morton.mul_matrix(b_morton)(0, 0);
+           }, repeats));
+    report("transpose row-major", n,
+           time_ms([&] { sink += a.transpose()(0, 1); }, repeats));
+    report("transpose tiled", n,
+           time_ms([&] { sink += a_blocked.transpose()(0, 1); }, repeats));
+    report("element access operator()", n, time_ms([&] {
+             const S21Matrix& view = a;
+             for (int i = 0; i < view.get_rows(); ++i) {
+               for (int j = 0; j < view.get_cols(); ++j) {
+                 sink += view(i, j);
+               }
+             }
+           }, repeats));
+    report("determinant (LU)", n,
+           time_ms([&] { sink += a.determinant(); }, repeats));
+    report("lu_decompose row-major", n, time_ms([&] {
+             sink += a.lu_decompose().lu(0, 0);
+           }, repeats));
+    report("lu_decompose tiled", n, time_ms([&] {
+             sink += a_blocked.lu_decompose().lu(0, 0);
+           }, repeats));
+    if (sink == 42.0) {
+      std::cout << sink << std::endl;
+    }
+  }
+  return 0;
+}
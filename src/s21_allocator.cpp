@@ -0,0 +1,146 @@
+#include "s21_allocator.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+#include "s21_thread_pool.h"
+
+#ifdef __linux__
+#include <sys/syscall.h>
+
+#include <climits>
+#include <fstream>
+#include <sstream>
+#include <string>
+#endif
+
+namespace {
+std::mutex policy_mutex;
+S21AllocationPolicy current_policy;
+
+// длина отображения кратна 2 MiB, чтобы munmap одинаково работал и для
+// MAP_HUGETLB, и для обычных страниц; поэтому размер huge page задаётся
+// явно, а не берётся системный по умолчанию (он может быть 1 GiB)
+std::size_t mapping_length(std::size_t bytes) {
+  const std::size_t huge = S21Allocation::kLargeAllocation;
+  return (bytes + huge - 1) / huge * huge;
+}
+
+#ifdef __linux__
+constexpr int kMaskBits = sizeof(unsigned long) * CHAR_BIT;
+
+// маска узлов в сети; формат списка "0", "0-3" или "0,2-3"
+unsigned long online_nodes() {
+  unsigned long mask = 0;
+  std::ifstream online("/sys/devices/system/node/online");
+  std::string list;
+  if (online >> list) {
+    std::istringstream items(list);
+    int first = 0;
+    while (items >> first) {
+      int last = first;
+      if (items.peek() == '-') {
+        items.get();
+        items >> last;
+      }
+      for (int node = std::max(first, 0); node <= last && node < kMaskBits;
+           ++node) {
+        mask |= 1UL << node;
+      }
+      if (items.peek() == ',') {
+        items.get();
+      }
+    }
+  }
+  return mask;
+}
+
+void interleave(void* ptr, std::size_t length) {
+  const unsigned long mask = online_nodes();
+  // один узел или ни одного: чередовать нечего
+  if ((mask & (mask - 1)) != 0) {
+    const int kMpolInterleave = 3;
+    // ядро читает maxnode - 1 бит маски
+    syscall(SYS_mbind, ptr, length, kMpolInterleave, &mask, kMaskBits + 1,
+            0);
+  }
+}
+#endif
+
+void* map_pages(std::size_t length, bool huge_pages) {
+  void* ptr = MAP_FAILED;
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+  if (huge_pages) {
+    const int kHuge2Mb = 21 << MAP_HUGE_SHIFT;
+    ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | kHuge2Mb, -1, 0);
+  }
+#endif
+  if (ptr == MAP_FAILED) {
+    ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+    if (ptr != MAP_FAILED && huge_pages) {
+      madvise(ptr, length, MADV_HUGEPAGE);
+    }
+#endif
+  }
+  return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+// страница достаётся тому потоку (и узлу), который коснётся её первым
+void first_touch(void* ptr, std::size_t length) {
+  const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  const int pages = static_cast<int>(length / page);
+  char* base = static_cast<char*>(ptr);
+  S21ThreadPool::instance().parallel_for(
+      0, pages, 64, [base, page](int lo, int hi) {
+        for (int p = lo; p < hi; ++p) {
+          base[static_cast<std::size_t>(p) * page] = 0;
+        }
+      });
+}
+}  // namespace
+
+void S21Allocation::set_policy(const S21AllocationPolicy& policy) {
+  std::lock_guard<std::mutex> lock(policy_mutex);
+  current_policy = policy;
+}
+
+S21AllocationPolicy S21Allocation::get_policy() {
+  std::lock_guard<std::mutex> lock(policy_mutex);
+  return current_policy;
+}
+
+void* S21Allocation::allocate(std::size_t bytes) {
+  if (bytes < kLargeAllocation) {
+    return ::operator new(bytes);
+  }
+  const S21AllocationPolicy policy = get_policy();
+  const std::size_t length = mapping_length(bytes);
+  void* ptr = map_pages(length, policy.huge_pages);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+#ifdef __linux__
+  if (policy.numa_interleave) {
+    interleave(ptr, length);
+  }
+#endif
+  if (policy.parallel_first_touch) {
+    first_touch(ptr, length);
+  }
+  return ptr;
+}
+
+void S21Allocation::deallocate(void* ptr, std::size_t bytes) noexcept {
+  if (bytes < kLargeAllocation) {
+    ::operator delete(ptr);
+  } else if (ptr != nullptr) {
+    munmap(ptr, mapping_length(bytes));
+  }
+}
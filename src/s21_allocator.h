@@ -0,0 +1,75 @@
+#ifndef S21ALLOCATOR_H
+#define S21ALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Политика размещения больших матриц (от kLargeAllocation байт).
+struct S21AllocationPolicy {
+  // прозрачные huge pages (madvise) или MAP_HUGETLB, если доступны
+  bool huge_pages = false;
+  // первое касание страниц выполняют потоки S21ThreadPool; потоки не
+  // привязаны к ядрам, так что узел страницы не гарантируется -
+  // размещением управляет только numa_interleave
+  bool parallel_first_touch = false;
+  // чередование страниц между NUMA-узлами
+  bool numa_interleave = false;
+};
+
+// Большие блоки выделяются через mmap, остальные - operator new.
+// Если запрошенная возможность недоступна, она молча пропускается.
+class S21Allocation {
+ public:
+  static constexpr std::size_t kLargeAllocation = std::size_t(1) << 21;
+
+  static void set_policy(const S21AllocationPolicy& policy);
+  static S21AllocationPolicy get_policy();
+
+  static void* allocate(std::size_t bytes);
+  static void deallocate(void* ptr, std::size_t bytes) noexcept;
+};
+
+template <class T>
+class S21Allocator {
+ public:
+  using value_type = T;
+
+  S21Allocator() noexcept = default;
+  template <class U>
+  S21Allocator(const S21Allocator<U>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    if (n > static_cast<std::size_t>(-1) / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T*>(S21Allocation::allocate(n * sizeof(T)));
+  }
+  void deallocate(T* ptr, std::size_t n) noexcept {
+    S21Allocation::deallocate(ptr, n * sizeof(T));
+  }
+
+  // Value-инициализация ничего не пишет: resize(n) не обнуляет память
+  // последовательно, нули проставляет владелец (S21Matrix - параллельно).
+  template <class U>
+  void construct(U* ptr) noexcept(
+      std::is_nothrow_default_constructible<U>::value) {
+    ::new (static_cast<void*>(ptr)) U;
+  }
+  template <class U, class... Args>
+  void construct(U* ptr, Args&&... args) {
+    ::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+  }
+
+  template <class U>
+  bool operator==(const S21Allocator<U>&) const noexcept {
+    return true;
+  }
+  template <class U>
+  bool operator!=(const S21Allocator<U>&) const noexcept {
+    return false;
+  }
+};
+
+#endif  // S21ALLOCATOR_H
@@ -0,0 +1,156 @@
+#include "s21_kronecker.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_thread_pool.h"
+#include "s21_tuning.h"
+
+namespace {
+int checked_product(int x, int y) {
+  const long long product = static_cast<long long>(x) * y;
+  if (product > std::numeric_limits<int>::max()) {
+    throw std::invalid_argument("Kronecker product is too large.");
+  }
+  return static_cast<int>(product);
+}
+}  // namespace
+
+S21KroneckerOperator::S21KroneckerOperator(const S21Matrix& a,
+                                           const S21Matrix& b)
+    : a_(a), b_(b), b_transposed_(b.transpose()) {
+  if (a.get_rows() < 1 || b.get_rows() < 1) {
+    throw std::invalid_argument("Kronecker factors cannot be empty.");
+  }
+  rows_ = checked_product(a.get_rows(), b.get_rows());
+  cols_ = checked_product(a.get_cols(), b.get_cols());
+}
+
+S21Matrix S21KroneckerOperator::kron(const S21Matrix& a, const S21Matrix& b) {
+  if (a.get_rows() < 1 || b.get_rows() < 1) {
+    throw std::invalid_argument("Kronecker factors cannot be empty.");
+  }
+  const int n = a.get_cols();
+  const int p = b.get_rows();
+  const int q = b.get_cols();
+  S21Matrix result(checked_product(a.get_rows(), p), checked_product(n, q));
+  const int cols = result.get_cols();
+  // указатель берётся один раз: data() меняет версию матрицы
+  double* out = result.data();
+  auto fill_rows = [&a, &b, out, n, p, q, cols](int lo, int hi) {
+    for (int row = lo; row < hi; ++row) {
+      const double* a_row = a.row_data(row / p);
+      const double* b_row = b.row_data(row % p);
+      double* out_row = out + static_cast<std::size_t>(row) * cols;
+      for (int j = 0; j < n; ++j) {
+        const double a_ij = a_row[j];
+        double* tile = out_row + static_cast<std::size_t>(j) * q;
+        for (int l = 0; l < q; ++l) {
+          tile[l] = a_ij * b_row[l];
+        }
+      }
+    }
+  };
+  const std::size_t grain = S21Tuning::get().reduce_parallel_size / cols + 1;
+  S21ThreadPool::instance().parallel_for(
+      0, result.get_rows(),
+      static_cast<int>(std::min<std::size_t>(grain, result.get_rows())),
+      fill_rows);
+  return result;
+}
+
+int S21KroneckerOperator::get_rows() const noexcept { return rows_; }
+
+int S21KroneckerOperator::get_cols() const noexcept { return cols_; }
+
+S21Matrix S21KroneckerOperator::to_matrix() const { return kron(a_, b_); }
+
+S21Matrix S21KroneckerOperator::mul_matrix(const S21Matrix& x) const {
+  if (x.get_rows() != cols_ || x.get_cols() < 1) {
+    throw std::invalid_argument(
+        "Matrix sizes do not match for multiplication.");
+  }
+  const int n = a_.get_cols();
+  const int q = b_.get_cols();
+  S21Matrix result(rows_, x.get_cols());
+  S21Matrix folded(n, q);
+  for (int c = 0; c < x.get_cols(); ++c) {
+    std::copy(x.col_begin(c), x.col_end(c), folded.begin());
+    S21Matrix y = a_ * folded * b_transposed_;
+    const double* values = y.data();
+    for (int row = 0; row < rows_; ++row) {
+      result.at_unchecked(row, c) = values[row];
+    }
+  }
+  return result;
+}
+
+S21BlockDiagonalMatrix::S21BlockDiagonalMatrix(std::vector<S21Matrix> blocks)
+    : blocks_(std::move(blocks)), rows_(0), cols_(0) {
+  for (const S21Matrix& block : blocks_) {
+    if (block.get_rows() < 1) {
+      throw std::invalid_argument("Diagonal blocks cannot be empty.");
+    }
+    rows_ += block.get_rows();
+    cols_ += block.get_cols();
+  }
+}
+
+int S21BlockDiagonalMatrix::get_rows() const noexcept { return rows_; }
+
+int S21BlockDiagonalMatrix::get_cols() const noexcept { return cols_; }
+
+int S21BlockDiagonalMatrix::get_block_count() const noexcept {
+  return static_cast<int>(blocks_.size());
+}
+
+const S21Matrix& S21BlockDiagonalMatrix::block(int index) const {
+  if (index < 0 || index >= get_block_count()) {
+    throw std::out_of_range("Block index is out of range.");
+  }
+  return blocks_[index];
+}
+
+S21Matrix S21BlockDiagonalMatrix::to_matrix() const {
+  S21Matrix result(rows_, cols_);
+  int row = 0;
+  int col = 0;
+  for (const S21Matrix& block : blocks_) {
+    for (int i = 0; i < block.get_rows(); ++i) {
+      std::copy(block.row_begin(i), block.row_end(i),
+                result.row_data(row + i) + col);
+    }
+    row += block.get_rows();
+    col += block.get_cols();
+  }
+  return result;
+}
+
+S21Matrix S21BlockDiagonalMatrix::mul_matrix(const S21Matrix& x) const {
+  if (x.get_rows() != cols_ || x.get_cols() < 1) {
+    throw std::invalid_argument(
+        "Matrix sizes do not match for multiplication.");
+  }
+  const int width = x.get_cols();
+  S21Matrix result(rows_, width);
+  int row = 0;
+  int col = 0;
+  for (const S21Matrix& block : blocks_) {
+    for (int i = 0; i < block.get_rows(); ++i) {
+      const double* block_row = block.row_data(i);
+      double* out = result.row_data(row + i);
+      for (int j = 0; j < block.get_cols(); ++j) {
+        const double value = block_row[j];
+        const double* x_row = x.row_data(col + j);
+        for (int c = 0; c < width; ++c) {
+          out[c] += value * x_row[c];
+        }
+      }
+    }
+    row += block.get_rows();
+    col += block.get_cols();
+  }
+  return result;
+}
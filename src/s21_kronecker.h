@@ -0,0 +1,56 @@
+#ifndef S21KRONECKER_H
+#define S21KRONECKER_H
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Кронекерово произведение A ⊗ B (A: m x n, B: p x q) без построения
+// матрицы (m p) x (n q). Элемент ((i, k), (j, l)) равен A(i, j) * B(k, l),
+// строки и столбцы нумеруются как i * p + k и j * q + l.
+class S21KroneckerOperator {
+ public:
+  S21KroneckerOperator(const S21Matrix& a, const S21Matrix& b);
+
+  // явное A ⊗ B: каждая строка результата пишется подряд кусками по q
+  static S21Matrix kron(const S21Matrix& a, const S21Matrix& b);
+
+  int get_rows() const noexcept;
+  int get_cols() const noexcept;
+
+  S21Matrix to_matrix() const;
+  // (A ⊗ B) * X через vec-тождество: столбец X, разложенный построчно
+  // в матрицу n x q, переходит в A * X * B^T. O(m n q + m q p) на столбец
+  // вместо O(m n p q).
+  S21Matrix mul_matrix(const S21Matrix& x) const;
+
+ private:
+  S21Matrix a_;
+  S21Matrix b_;
+  S21Matrix b_transposed_;
+  int rows_;
+  int cols_;
+};
+
+// Блочно-диагональная матрица: хранятся только блоки, блоки
+// могут быть прямоугольными.
+class S21BlockDiagonalMatrix {
+ public:
+  explicit S21BlockDiagonalMatrix(std::vector<S21Matrix> blocks);
+
+  int get_rows() const noexcept;
+  int get_cols() const noexcept;
+  int get_block_count() const noexcept;
+  const S21Matrix& block(int index) const;
+
+  S21Matrix to_matrix() const;
+  // каждый блок умножается на свою полосу строк X
+  S21Matrix mul_matrix(const S21Matrix& x) const;
+
+ private:
+  std::vector<S21Matrix> blocks_;
+  int rows_;
+  int cols_;
+};
+
+#endif  // S21KRONECKER_H
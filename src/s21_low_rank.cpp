@@ -0,0 +1,204 @@
+#include "s21_low_rank.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace {
+constexpr int kMaxJacobiSweeps = 60;
+
+double dot(const double* x, const double* y, int n) {
+  double sum = 0.0;
+  for (int k = 0; k < n; ++k) {
+    sum += x[k] * y[k];
+  }
+  return sum;
+}
+
+// Применение отражения H = I - beta * v * v^T к строкам first.. матрицы
+// и столбцам [col_begin, cols): w = v^T * A накапливается построчно,
+// чтобы обход шёл по непрерывной памяти.
+void apply_reflector(S21Matrix& a, int first, const std::vector<double>& v,
+                     double beta, int col_begin, std::vector<double>& w) {
+  const int rows = a.get_rows();
+  const int cols = a.get_cols();
+  std::fill(w.begin() + col_begin, w.begin() + cols, 0.0);
+  for (int i = first; i < rows; ++i) {
+    const double* row = a.row_data(i);
+    const double v_i = v[i - first];
+    for (int j = col_begin; j < cols; ++j) {
+      w[j] += v_i * row[j];
+    }
+  }
+  for (int i = first; i < rows; ++i) {
+    double* row = a.row_data(i);
+    const double scale = beta * v[i - first];
+    for (int j = col_begin; j < cols; ++j) {
+      row[j] -= scale * w[j];
+    }
+  }
+}
+
+void rotate_rows(S21Matrix& m, int p, int q, double c, double s) {
+  double* x = m.row_data(p);
+  double* y = m.row_data(q);
+  for (int k = 0; k < m.get_cols(); ++k) {
+    const double xk = x[k];
+    x[k] = c * xk - s * y[k];
+    y[k] = s * xk + c * y[k];
+  }
+}
+}  // namespace
+
+S21Matrix S21SvdFactorization::reconstruct() const {
+  S21Matrix scaled(u);
+  for (int i = 0; i < scaled.get_rows(); ++i) {
+    double* row = scaled.row_data(i);
+    for (int j = 0; j < scaled.get_cols(); ++j) {
+      row[j] *= s[j];
+    }
+  }
+  return scaled * v.transpose();
+}
+
+S21QrFactorization S21LowRank::qr(const S21Matrix& a) {
+  const int m = a.get_rows();
+  const int n = a.get_cols();
+  if (m < 1 || n < 1) {
+    throw std::invalid_argument("QR of an empty matrix is undefined.");
+  }
+  const int k = std::min(m, n);
+  S21Matrix work(a);
+  std::vector<std::vector<double>> reflectors(k);
+  std::vector<double> betas(k, 0.0);
+  std::vector<double> w(std::max(m, n));
+  for (int c = 0; c < k; ++c) {
+    std::vector<double>& v = reflectors[c];
+    v.resize(m - c);
+    for (int i = c; i < m; ++i) {
+      v[i - c] = work.at_unchecked(i, c);
+    }
+    const double norm = std::sqrt(dot(v.data(), v.data(), m - c));
+    if (norm == 0.0) {
+      continue;
+    }
+    // знак выбирается так, чтобы не было вычитания близких чисел
+    const double alpha = v[0] > 0.0 ? -norm : norm;
+    v[0] -= alpha;
+    betas[c] = 2.0 / dot(v.data(), v.data(), m - c);
+    apply_reflector(work, c, v, betas[c], c, w);
+  }
+  S21QrFactorization result{S21Matrix(m, k), S21Matrix(k, n)};
+  for (int i = 0; i < k; ++i) {
+    std::copy(work.row_data(i) + i, work.row_data(i) + n,
+              result.r.row_data(i) + i);
+  }
+  // Q = H_0 * ... * H_{k-1} * [I; 0], отражения применяются с конца
+  for (int i = 0; i < k; ++i) {
+    result.q.at_unchecked(i, i) = 1.0;
+  }
+  for (int c = k - 1; c >= 0; --c) {
+    if (betas[c] != 0.0) {
+      apply_reflector(result.q, c, reflectors[c], betas[c], c, w);
+    }
+  }
+  return result;
+}
+
+S21Matrix S21LowRank::range_finder(const S21Matrix& a, int rank,
+                                   const S21SketchOptions& options) {
+  const int m = a.get_rows();
+  const int n = a.get_cols();
+  if (rank < 1 || rank > std::min(m, n)) {
+    throw std::invalid_argument("Rank is out of range for the matrix.");
+  }
+  if (options.oversampling < 0 || options.power_iterations < 0) {
+    throw std::invalid_argument("Sketch options cannot be negative.");
+  }
+  const int width = std::min(rank + options.oversampling, std::min(m, n));
+  std::mt19937_64 generator(options.seed);
+  std::normal_distribution<double> gaussian;
+  S21Matrix omega(n, width);
+  std::generate(omega.begin(), omega.end(),
+                [&] { return gaussian(generator); });
+  S21Matrix q = qr(a * omega).q;
+  // между умножениями базис переортогонализуется, иначе столбцы
+  // сливаются к старшему сингулярному вектору
+  for (int it = 0; it < options.power_iterations; ++it) {
+    S21Matrix z = qr((q.transpose() * a).transpose()).q;
+    q = qr(a * z).q;
+  }
+  return q;
+}
+
+S21SvdFactorization S21LowRank::svd(const S21Matrix& a, int rank,
+                                    const S21SketchOptions& options) {
+  S21Matrix q = range_finder(a, rank, options);
+  S21SvdFactorization small = jacobi_svd(q.transpose() * a);
+  S21SvdFactorization result{q * small.u, small.s, small.v};
+  result.u.set_cols(rank);
+  result.v.set_cols(rank);
+  result.s.resize(rank);
+  return result;
+}
+
+// Односторонний метод Якоби: вращения строк B делают их попарно
+// ортогональными, G * B = diag(s) * V^T, откуда B = G^T * diag(s) * V^T.
+S21SvdFactorization S21LowRank::jacobi_svd(S21Matrix b) {
+  const int l = b.get_rows();
+  const int n = b.get_cols();
+  S21Matrix g(l, l);
+  for (int i = 0; i < l; ++i) {
+    g.at_unchecked(i, i) = 1.0;
+  }
+  const double eps = std::numeric_limits<double>::epsilon();
+  bool rotated = true;
+  for (int sweep = 0; sweep < kMaxJacobiSweeps && rotated; ++sweep) {
+    rotated = false;
+    for (int p = 0; p < l - 1; ++p) {
+      for (int q = p + 1; q < l; ++q) {
+        const double alpha = dot(b.row_data(p), b.row_data(p), n);
+        const double beta = dot(b.row_data(q), b.row_data(q), n);
+        const double gamma = dot(b.row_data(p), b.row_data(q), n);
+        if (std::fabs(gamma) <= eps * std::sqrt(alpha * beta)) {
+          continue;
+        }
+        rotated = true;
+        const double zeta = (beta - alpha) / (2.0 * gamma);
+        const double t = (zeta >= 0.0 ? 1.0 : -1.0) /
+                         (std::fabs(zeta) + std::sqrt(1.0 + zeta * zeta));
+        const double c = 1.0 / std::sqrt(1.0 + t * t);
+        rotate_rows(b, p, q, c, c * t);
+        rotate_rows(g, p, q, c, c * t);
+      }
+    }
+  }
+  std::vector<double> norms(l);
+  for (int i = 0; i < l; ++i) {
+    norms[i] = std::sqrt(dot(b.row_data(i), b.row_data(i), n));
+  }
+  std::vector<int> order(l);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&norms](int x, int y) { return norms[x] > norms[y]; });
+  S21SvdFactorization result{S21Matrix(l, l), std::vector<double>(l),
+                             S21Matrix(n, l)};
+  for (int j = 0; j < l; ++j) {
+    const int source = order[j];
+    result.s[j] = norms[source];
+    const double* g_row = g.row_data(source);
+    const double* b_row = b.row_data(source);
+    for (int i = 0; i < l; ++i) {
+      result.u.at_unchecked(i, j) = g_row[i];
+    }
+    if (norms[source] > 0.0) {
+      for (int i = 0; i < n; ++i) {
+        result.v.at_unchecked(i, j) = b_row[i] / norms[source];
+      }
+    }
+  }
+  return result;
+}
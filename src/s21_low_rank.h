@@ -0,0 +1,53 @@
+#ifndef S21LOWRANK_H
+#define S21LOWRANK_H
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Тонкое QR-разложение A = Q * R: у Q (m x k) ортонормированные столбцы,
+// R (k x n) верхнетреугольная, k = min(m, n).
+struct S21QrFactorization {
+  S21Matrix q;
+  S21Matrix r;
+};
+
+// Усечённое SVD: A ~ U * diag(s) * V^T, s по убыванию.
+struct S21SvdFactorization {
+  S21Matrix u;
+  std::vector<double> s;
+  S21Matrix v;
+
+  S21Matrix reconstruct() const;
+};
+
+// Параметры случайного эскиза: к рангу добавляется oversampling
+// столбцов, power_iterations шагов (A A^T)^q уточняют базис для
+// медленно убывающего спектра.
+struct S21SketchOptions {
+  int oversampling = 10;
+  int power_iterations = 2;
+  unsigned long long seed = 42;
+};
+
+// Рандомизированные низкоранговые приближения за O(m * n * k).
+class S21LowRank {
+ public:
+  // отражения Хаусхолдера
+  static S21QrFactorization qr(const S21Matrix& a);
+
+  // ортонормированный базис (m x l) приближённого образа A,
+  // l = min(rank + oversampling, m, n)
+  static S21Matrix range_finder(const S21Matrix& a, int rank,
+                                const S21SketchOptions& options = {});
+
+  // первые rank сингулярных троек
+  static S21SvdFactorization svd(const S21Matrix& a, int rank,
+                                 const S21SketchOptions& options = {});
+
+ private:
+  // SVD малой матрицы (строк не больше, чем столбцов) методом Якоби
+  static S21SvdFactorization jacobi_svd(S21Matrix b);
+};
+
+#endif  // S21LOWRANK_H
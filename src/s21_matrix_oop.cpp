@@ -1,52 +1,368 @@
 #include "s21_matrix_oop.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <new>
+#include <numeric>
+#include <utility>
+
+#include "s21_thread_pool.h"
+#include "s21_tuning.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define S21_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace {
+// до этого размера определитель считается разложением по строке,
+// для больших матриц - через LU-разложение
+constexpr int kCofactorLimit = 3;
+// до этого размера определитель с ведущим элементом LU на уровне ошибок
+// округления пересчитывается по минорам, чтобы точный ноль остался нулём
+constexpr int kCofactorFallbackLimit = 8;
+// размеры блоков и пороги параллельности берутся из S21Tuning::get()
+// ниже этого размера попарное суммирование переходит в прямой цикл
+constexpr std::size_t kPairwiseBlock = 128;
+
+// Попарная сумма transform(x[k]): ошибка растёт как O(log n), а не O(n).
+// Прямой цикл с четырьмя аккумуляторами компилятор векторизует.
+template <class F>
+double pairwise_sum(const double* x, std::size_t n, F transform) {
+  if (n <= kPairwiseBlock) {
+    double acc[4] = {0.0, 0.0, 0.0, 0.0};
+    std::size_t k = 0;
+    for (; k + 4 <= n; k += 4) {
+      acc[0] += transform(x[k]);
+      acc[1] += transform(x[k + 1]);
+      acc[2] += transform(x[k + 2]);
+      acc[3] += transform(x[k + 3]);
+    }
+    for (; k < n; ++k) {
+      acc[0] += transform(x[k]);
+    }
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+  }
+  const std::size_t half = n / 2 / 4 * 4;
+  return pairwise_sum(x, half, transform) +
+         pairwise_sum(x + half, n - half, transform);
+}
+
+// Сумма большого массива: куски считаются в пуле, частичные суммы
+// складываются тоже попарно.
+template <class F>
+double parallel_sum(const double* x, std::size_t n, F transform) {
+  if (n < S21Tuning::get().reduce_parallel_size) {
+    return pairwise_sum(x, n, transform);
+  }
+  S21ThreadPool& pool = S21ThreadPool::instance();
+  const int parts = static_cast<int>(pool.get_threads()) + 1;
+  const std::size_t step = (n + parts - 1) / parts;
+  std::vector<double> partial(parts, 0.0);
+  pool.parallel_for(0, parts, 1, [&](int lo, int hi) {
+    for (int p = lo; p < hi; ++p) {
+      const std::size_t begin = std::min(n, p * step);
+      const std::size_t end = std::min(n, begin + step);
+      partial[p] = pairwise_sum(x + begin, end - begin, transform);
+    }
+  });
+  return pairwise_sum(partial.data(), partial.size(),
+                      [](double v) { return v; });
+}
+
+// Максимум, в котором NaN не теряется: std::max(acc, NaN) вернул бы acc.
+inline double nan_max(double acc, double v) noexcept {
+  return (v > acc || std::isnan(v)) ? v : acc;
+}
+
+inline double nan_min(double acc, double v) noexcept {
+  return (v < acc || std::isnan(v)) ? v : acc;
+}
+
+double parallel_max_abs(const double* x, std::size_t n) {
+  auto block_max = [x](std::size_t begin, std::size_t end) {
+    double acc[4] = {0.0, 0.0, 0.0, 0.0};
+    std::size_t k = begin;
+    for (; k + 4 <= end; k += 4) {
+      acc[0] = nan_max(acc[0], std::fabs(x[k]));
+      acc[1] = nan_max(acc[1], std::fabs(x[k + 1]));
+      acc[2] = nan_max(acc[2], std::fabs(x[k + 2]));
+      acc[3] = nan_max(acc[3], std::fabs(x[k + 3]));
+    }
+    for (; k < end; ++k) {
+      acc[0] = nan_max(acc[0], std::fabs(x[k]));
+    }
+    return nan_max(nan_max(acc[0], acc[1]), nan_max(acc[2], acc[3]));
+  };
+  if (n < S21Tuning::get().reduce_parallel_size) {
+    return block_max(0, n);
+  }
+  S21ThreadPool& pool = S21ThreadPool::instance();
+  const int parts = static_cast<int>(pool.get_threads()) + 1;
+  const std::size_t step = (n + parts - 1) / parts;
+  std::vector<double> partial(parts, 0.0);
+  pool.parallel_for(0, parts, 1, [&](int lo, int hi) {
+    for (int p = lo; p < hi; ++p) {
+      const std::size_t begin = std::min(n, p * step);
+      partial[p] = block_max(begin, std::min(n, begin + step));
+    }
+  });
+  return std::accumulate(partial.begin(), partial.end(), 0.0, nan_max);
+}
+
+// элементов в куске сравнения
+constexpr std::size_t kCompareChunk = 256;
+
+std::atomic<double> default_absolute{0.0};
+std::atomic<double> default_relative{0.0};
+std::atomic<std::uint64_t> default_ulps{0};
+
+std::uint64_t ulp_distance(double x, double y) noexcept {
+  auto ordered = [](double v) {
+    std::int64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    // отрицательные числа в порядке возрастания
+    return bits < 0 ? std::numeric_limits<std::int64_t>::min() - bits : bits;
+  };
+  const std::int64_t a = ordered(x);
+  const std::int64_t b = ordered(y);
+  return a > b ? static_cast<std::uint64_t>(a) - static_cast<std::uint64_t>(b)
+               : static_cast<std::uint64_t>(b) - static_cast<std::uint64_t>(a);
+}
+
+bool near_equal(double x, double y, const S21Tolerance& tolerance) noexcept {
+  if (x == y) {
+    return true;
+  }
+  if (std::isnan(x) || std::isnan(y)) {
+    return false;
+  }
+  const double diff = std::fabs(x - y);
+  return diff <= tolerance.absolute ||
+         diff <= tolerance.relative * std::max(std::fabs(x), std::fabs(y)) ||
+         ulp_distance(x, y) <= tolerance.ulps;
+}
+
+// Есть ли в куске элемент, не проходящий допуски absolute и relative.
+// NaN и разность бесконечностей тоже считаются подозрительными,
+// окончательно их проверяет near_equal.
+using ChunkSuspect = bool (*)(const double*, const double*,
+                              const S21Tolerance&);
+
+bool chunk_suspect_portable(const double* x, const double* y,
+                            const S21Tolerance& tolerance) {
+  bool suspect = false;
+  for (std::size_t c = 0; c < kCompareChunk; ++c) {
+    const double limit = std::max(
+        tolerance.absolute,
+        tolerance.relative * std::max(std::fabs(x[c]), std::fabs(y[c])));
+    suspect |= !(std::fabs(x[c] - y[c]) <= limit);
+  }
+  return suspect;
+}
+
+#ifdef S21_X86_KERNELS
+// GCC не векторизует свёртку логических значений по сравнению double
+__attribute__((target("avx2"))) bool chunk_suspect_avx2(
+    const double* x, const double* y, const S21Tolerance& tolerance) {
+  const __m256d sign = _mm256_set1_pd(-0.0);
+  const __m256d absolute = _mm256_set1_pd(tolerance.absolute);
+  const __m256d relative = _mm256_set1_pd(tolerance.relative);
+  __m256d suspect = _mm256_setzero_pd();
+  for (std::size_t c = 0; c < kCompareChunk; c += 4) {
+    const __m256d a = _mm256_loadu_pd(x + c);
+    const __m256d b = _mm256_loadu_pd(y + c);
+    const __m256d diff = _mm256_andnot_pd(sign, _mm256_sub_pd(a, b));
+    const __m256d magnitude = _mm256_max_pd(_mm256_andnot_pd(sign, a),
+                                            _mm256_andnot_pd(sign, b));
+    const __m256d limit =
+        _mm256_max_pd(absolute, _mm256_mul_pd(relative, magnitude));
+    // неупорядоченное сравнение истинно и для NaN
+    suspect = _mm256_or_pd(suspect, _mm256_cmp_pd(diff, limit, _CMP_NLE_UQ));
+  }
+  return _mm256_movemask_pd(suspect) != 0;
+}
+#endif
+
+ChunkSuspect select_chunk_suspect() {
+#ifdef S21_X86_KERNELS
+  if (__builtin_cpu_supports("avx2")) {
+    return chunk_suspect_avx2;
+  }
+#endif
+  return chunk_suspect_portable;
+}
+
+// Индекс первого различия в [begin, end) или end. Поэлементно
+// (с учётом ulps) проверяются только подозрительные куски. Поиск
+// прекращается, когда stop уже меньше начала куска.
+std::size_t first_mismatch(const double* x, const double* y,
+                           std::size_t begin, std::size_t end,
+                           const S21Tolerance& tolerance,
+                           const std::atomic<std::size_t>* stop) noexcept {
+  static const ChunkSuspect chunk_suspect = select_chunk_suspect();
+  std::size_t k = begin;
+  for (; k + kCompareChunk <= end; k += kCompareChunk) {
+    if (stop != nullptr && stop->load(std::memory_order_relaxed) < k) {
+      return end;
+    }
+    if (chunk_suspect(x + k, y + k, tolerance)) {
+      for (std::size_t c = k; c < k + kCompareChunk; ++c) {
+        if (!near_equal(x[c], y[c], tolerance)) {
+          return c;
+        }
+      }
+    }
+  }
+  for (; k < end; ++k) {
+    if (!near_equal(x[k], y[k], tolerance)) {
+      return k;
+    }
+  }
+  return end;
+}
+
+// Эпилог gemm для участка [begin, end) строки i результата.
+void apply_epilogue(const S21GemmEpilogue& epilogue, int i, double* c_row,
+                    int begin, int end) {
+  if (epilogue.bias_mode == S21BiasMode::kPerRow) {
+    const double shift = epilogue.bias[i];
+    for (int j = begin; j < end; ++j) {
+      c_row[j] += shift;
+    }
+  } else if (epilogue.bias_mode == S21BiasMode::kPerCol) {
+    for (int j = begin; j < end; ++j) {
+      c_row[j] += epilogue.bias[j];
+    }
+  }
+  switch (epilogue.activation) {
+    case S21Activation::kRelu:
+      for (int j = begin; j < end; ++j) {
+        c_row[j] = std::max(c_row[j], 0.0);
+      }
+      break;
+    case S21Activation::kSigmoid:
+      for (int j = begin; j < end; ++j) {
+        c_row[j] = 1.0 / (1.0 + std::exp(-c_row[j]));
+      }
+      break;
+    case S21Activation::kTanh:
+      for (int j = begin; j < end; ++j) {
+        c_row[j] = std::tanh(c_row[j]);
+      }
+      break;
+    case S21Activation::kNone:
+      break;
+  }
+  if (epilogue.lower > -std::numeric_limits<double>::infinity() ||
+      epilogue.upper < std::numeric_limits<double>::infinity()) {
+    for (int j = begin; j < end; ++j) {
+      c_row[j] = std::clamp(c_row[j], epilogue.lower, epilogue.upper);
+    }
+  }
+}
+}  // namespace
+
+struct S21Matrix::Cache {
+  unsigned long long version = 0;
+  std::shared_ptr<const S21LuFactorization> lu;
+  std::shared_ptr<const double> determinant;
+  std::shared_ptr<const S21Matrix> complements;
+  std::shared_ptr<const S21Matrix> inverse;
+};
+
 S21Matrix::S21Matrix() : rows_(0), cols_(0) {
-  matrix_ = std::vector<std::vector<double>>(
-      rows_, std::vector<double>(
-                 cols_, 0.0));  // двумерный вектор, rows_ cтрок cодержит cols_
-                                // эл-тов типа double cо значением 0.0
+  // элементы хранятся построчно в одном непрерывном векторе
+  // из rows_ * cols_ значений типа double
 }
 
 S21Matrix::S21Matrix(int rows, int cols) : rows_(rows), cols_(cols) {
   if (rows_ < 1 || cols_ < 1) {
     throw std::length_error("Matrix dimensions cannot be less than one");
   } else {
-    matrix_.resize(rows_, std::vector<double>(cols_));
+    resize_storage(static_cast<std::size_t>(rows_) * cols_);
   }
 }
 
 S21Matrix::S21Matrix(const S21Matrix& other)
-    : rows_(other.rows_), cols_(other.cols_) {
-  matrix_ = std::vector<std::vector<double>>(rows_, std::vector<double>(cols_));
-  matrix_.assign(other.matrix_.begin(), other.matrix_.end());
-}
+    : rows_(other.rows_),
+      cols_(other.cols_),
+      matrix_(other.matrix_),
+      caching_(other.caching_) {}
 
 S21Matrix::S21Matrix(S21Matrix&& other) noexcept
     : rows_(other.rows_),
       cols_(other.cols_),
-      matrix_(std::move(other.matrix_)) {
+      matrix_(std::move(other.matrix_)),
+      version_(other.version_),
+      caching_(other.caching_),
+      cache_(std::move(other.cache_)) {
   other.rows_ = 0;
   other.cols_ = 0;
+  other.touch();
 }
 S21Matrix::~S21Matrix() {
 }  // деcтруктор S21Matrix вызывает деcтруктор std::vector, std::vector
    // cамоcтоятельно удаляет вcе элементы из вектора и оcвобождает выделенную
    // память.
 
-int S21Matrix::get_rows() const noexcept { return rows_; }
+void S21Matrix::set_caching(bool enabled) {
+  caching_ = enabled;
+  if (!enabled) {
+    cache_.reset();
+  }
+}
+
+bool S21Matrix::get_caching() const noexcept { return caching_; }
+
+unsigned long long S21Matrix::get_version() const noexcept { return version_; }
+
+S21Matrix::Cache* S21Matrix::current_cache() const {
+  if (!cache_) {
+    cache_ = std::make_unique<Cache>();
+  }
+  if (cache_->version != version_) {
+    *cache_ = Cache();
+    cache_->version = version_;
+  }
+  return cache_.get();
+}
+
+// Значения вычисляются вне блокировки: параллельные читатели могут
+// посчитать одно и то же дважды, но никогда не увидят частичный результат.
+template <class T>
+std::shared_ptr<const T> S21Matrix::cache_get(
+    std::shared_ptr<const T> Cache::*field) const {
+  std::shared_ptr<const T> result;
+  if (caching_) {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    result = current_cache()->*field;
+  }
+  return result;
+}
 
-int S21Matrix::get_cols() const noexcept { return cols_; }
+template <class T>
+void S21Matrix::cache_put(std::shared_ptr<const T> Cache::*field,
+                          const T& value) const {
+  if (caching_) {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    current_cache()->*field = std::make_shared<const T>(value);
+  }
+}
 
 void S21Matrix::set_rows(const int new_rows) {
   if (new_rows < 1) {
     throw std::length_error("Number of rows cannot be less than one");
   } else {
-    if (new_rows > rows_) {
-      matrix_.resize(new_rows, std::vector<double>(cols_));
-    } else {
-      matrix_.resize(new_rows);
-    }
+    const std::size_t size = static_cast<std::size_t>(new_rows) * cols_;
+    grow_to(size);
+    resize_storage(size);
     rows_ = new_rows;
+    touch();
   }
 }
 
@@ -54,119 +370,691 @@ void S21Matrix::set_cols(const int new_cols) {
   if (new_cols < 1) {
     throw std::length_error("Number of cols cannot be less than one");
   } else {
-    if (new_cols > cols_) {
-      for (auto& row : matrix_) {  //  позволяет нам пройти по каждой cтроке row
-                                   //  в векторе matrix_
-        row.resize(new_cols, 0.0);
+    const std::size_t old_cols = cols_;
+    const std::size_t cols = new_cols;
+    if (cols > old_cols) {
+      // строки сдвигаются с конца, чтобы не затереть ещё не перенесённые
+      grow_to(rows_ * cols);
+      resize_storage(rows_ * cols);
+      for (int i = rows_ - 1; i >= 0; --i) {
+        auto row = matrix_.begin() + i * old_cols;
+        std::copy_backward(row, row + old_cols, matrix_.begin() + i * cols +
+                                                    old_cols);
+        std::fill(matrix_.begin() + i * cols + old_cols,
+                  matrix_.begin() + (i + 1) * cols, 0.0);
       }
     } else {
-      for (auto& row : matrix_) {
-        row.resize(new_cols);
+      for (int i = 1; i < rows_; ++i) {
+        auto row = matrix_.begin() + i * old_cols;
+        std::copy(row, row + cols, matrix_.begin() + i * cols);
       }
+      matrix_.resize(rows_ * cols);
     }
     cols_ = new_cols;
+    touch();
   }
 }
 
+// При нехватке ёмкости она как минимум удваивается.
+void S21Matrix::grow_to(std::size_t size) {
+  if (size > matrix_.capacity()) {
+    matrix_.reserve(std::max(size, 2 * matrix_.capacity()));
+  }
+}
+
+void S21Matrix::resize_storage(std::size_t size) {
+  const std::size_t old_size = std::min(size, matrix_.size());
+  matrix_.resize(size);
+  double* tail = matrix_.data() + old_size;
+  const std::size_t count = size - old_size;
+  const std::size_t chunk = S21Allocation::kLargeAllocation / sizeof(double);
+  if (count < chunk) {
+    std::fill_n(tail, count, 0.0);
+  } else {
+    const int chunks = static_cast<int>((count + chunk - 1) / chunk);
+    S21ThreadPool::instance().parallel_for(
+        0, chunks, 1, [tail, count, chunk](int lo, int hi) {
+          for (int c = lo; c < hi; ++c) {
+            const std::size_t begin = static_cast<std::size_t>(c) * chunk;
+            std::fill_n(tail + begin, std::min(chunk, count - begin), 0.0);
+          }
+        });
+  }
+}
+
+void S21Matrix::reserve(int rows, int cols) {
+  if (rows < 1 || cols < 1) {
+    throw std::length_error("Matrix dimensions cannot be less than one");
+  }
+  matrix_.reserve(static_cast<std::size_t>(rows) * cols);
+}
+
+std::size_t S21Matrix::capacity() const noexcept {
+  return matrix_.capacity();
+}
+
+void S21Matrix::shrink_to_fit() { matrix_.shrink_to_fit(); }
+
+void S21Matrix::append_row(const double* values, int count) {
+  if (count < 1) {
+    throw std::length_error("Number of cols cannot be less than one");
+  }
+  if (rows_ > 0 && count != cols_) {
+    throw std::invalid_argument("Row size does not match the matrix.");
+  }
+  const std::less<const double*> before;
+  if (!before(values, matrix_.data()) &&
+      before(values, matrix_.data() + matrix_.size())) {
+    // строка из самой матрицы: grow_to может освободить её память
+    append_row(std::vector<double>(values, values + count));
+    return;
+  }
+  grow_to(matrix_.size() + count);
+  matrix_.insert(matrix_.end(), values, values + count);
+  cols_ = count;
+  ++rows_;
+  touch();
+}
+
+void S21Matrix::append_row(const std::vector<double>& values) {
+  append_row(values.data(), static_cast<int>(values.size()));
+}
+
+void S21Matrix::append_rows(const S21Matrix& other) {
+  if (other.rows_ < 1) {
+    return;
+  }
+  if (rows_ > 0 && other.cols_ != cols_) {
+    throw std::invalid_argument("Row size does not match the matrix.");
+  }
+  if (&other == this) {
+    // вставлять диапазон вектора в него же нельзя
+    append_rows(S21Matrix(other));
+    return;
+  }
+  grow_to(matrix_.size() + other.matrix_.size());
+  matrix_.insert(matrix_.end(), other.matrix_.begin(), other.matrix_.end());
+  cols_ = other.cols_;
+  rows_ += other.rows_;
+  touch();
+}
+
 bool S21Matrix::eq_matrix(const S21Matrix& other) const noexcept {
-  bool are_equal = true;
+  return eq_matrix(other, get_default_tolerance());
+}
+
+bool S21Matrix::eq_matrix(const S21Matrix& other,
+                          const S21Tolerance& tolerance) const noexcept {
+  return !find_mismatch(other, tolerance);
+}
+
+std::optional<std::pair<int, int>> S21Matrix::find_mismatch(
+    const S21Matrix& other, const S21Tolerance& tolerance) const noexcept {
   if (rows_ != other.rows_ || cols_ != other.cols_) {
-    are_equal = false;
+    return std::make_pair(-1, -1);
   }
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) {
-      if (matrix_[i][j] != other.matrix_[i][j]) {
-        are_equal = false;
-        break;
-      }
-    }
-    if (!are_equal) {
-      break;
+  const double* x = matrix_.data();
+  const double* y = other.matrix_.data();
+  const std::size_t size = matrix_.size();
+  std::size_t index = size;
+  if (size < S21Tuning::get().reduce_parallel_size) {
+    index = first_mismatch(x, y, 0, size, tolerance, nullptr);
+  } else {
+    // части ищут независимо, найденный индекс останавливает
+    // части, которые дальше него
+    S21ThreadPool& pool = S21ThreadPool::instance();
+    const int parts = static_cast<int>(pool.get_threads()) + 1;
+    const std::size_t step = (size + parts - 1) / parts;
+    std::atomic<std::size_t> found(size);
+    try {
+      pool.parallel_for(0, parts, 1, [&](int lo, int hi) {
+        for (int p = lo; p < hi; ++p) {
+          const std::size_t begin = std::min(size, p * step);
+          const std::size_t end = std::min(size, begin + step);
+          const std::size_t at =
+              first_mismatch(x, y, begin, end, tolerance, &found);
+          if (at == end) {
+            continue;
+          }
+          std::size_t current = found.load();
+          while (at < current && !found.compare_exchange_weak(current, at)) {
+          }
+        }
+      });
+      index = found.load();
+    } catch (...) {
+      // без пула (нехватка памяти на задачи) - последовательно
+      index = first_mismatch(x, y, 0, size, tolerance, nullptr);
     }
   }
-  return are_equal;
+  if (index == size) {
+    return std::nullopt;
+  }
+  return std::make_pair(static_cast<int>(index / cols_),
+                        static_cast<int>(index % cols_));
+}
+
+void S21Matrix::set_default_tolerance(const S21Tolerance& tolerance) {
+  if (!(tolerance.absolute >= 0.0) || !(tolerance.relative >= 0.0)) {
+    throw std::invalid_argument("Tolerance cannot be negative.");
+  }
+  default_absolute.store(tolerance.absolute);
+  default_relative.store(tolerance.relative);
+  default_ulps.store(tolerance.ulps);
+}
+
+S21Tolerance S21Matrix::get_default_tolerance() noexcept {
+  return {default_absolute.load(std::memory_order_relaxed),
+          default_relative.load(std::memory_order_relaxed),
+          default_ulps.load(std::memory_order_relaxed)};
 }
 
 void S21Matrix::sum_matrix(const S21Matrix& other) {
-  if (rows_ != other.rows_ || cols_ != other.cols_) {
+  if (try_sum_matrix(other) != S21Status::kOk) {
     throw std::invalid_argument("Matrix sizes do not match for summation.");
-  } else {
-    for (int i = 0; i < rows_; ++i) {
-      for (int j = 0; j < cols_; ++j) {
-        matrix_[i][j] += other.matrix_[i][j];
-      }
-    }
   }
 }
 
 void S21Matrix::sub_matrix(const S21Matrix& other) {
-  if (rows_ != other.rows_ || cols_ != other.cols_) {
+  if (try_sub_matrix(other) != S21Status::kOk) {
     throw std::invalid_argument("Matrix sizes do not match for subtraction.");
-  } else {
-    for (int i = 0; i < rows_; ++i) {
-      for (int j = 0; j < cols_; ++j) {
-        matrix_[i][j] -= other.matrix_[i][j];
-      }
-    }
   }
 }
 
 void S21Matrix::mul_number(const double val) {  // nan
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) {
-      matrix_[i][j] *= val;
-    }
+  for (double& value : matrix_) {
+    value *= val;
   }
+  touch();
 }
 
 void S21Matrix::mul_matrix(const S21Matrix& other) {
-  if (cols_ != other.rows_) {
+  S21Status status = try_mul_matrix(other);
+  if (status == S21Status::kSizeMismatch) {
     throw std::invalid_argument(
         "Matrix sizes do not match for multiplication.");
+  } else if (status == S21Status::kOutOfMemory) {
+    throw std::bad_alloc();
+  }
+}
+
+double S21Matrix::trace() const {
+  if (rows_ != cols_) {
+    throw std::invalid_argument("Trace is defined only for square matrices.");
+  }
+  double acc[2] = {0.0, 0.0};
+  for (int i = 0; i < rows_; ++i) {
+    acc[i & 1] += matrix_[static_cast<std::size_t>(i) * cols_ + i];
+  }
+  return acc[0] + acc[1];
+}
+
+double S21Matrix::sum() const {
+  return parallel_sum(matrix_.data(), matrix_.size(),
+                      [](double v) { return v; });
+}
+
+double S21Matrix::norm_frobenius() const {
+  // масштабирование на максимум защищает от переполнения квадратов
+  const double scale = norm_max();
+  double result = 0.0;
+  if (scale > 0.0 && std::isfinite(scale)) {
+    const double inv = 1.0 / scale;
+    result = scale * std::sqrt(parallel_sum(
+                         matrix_.data(), matrix_.size(), [inv](double v) {
+                           const double t = v * inv;
+                           return t * t;
+                         }));
   } else {
-    S21Matrix result(rows_, other.cols_);
-    for (int i = 0; i < rows_; ++i) {
-      for (int j = 0; j < other.cols_; ++j) {
-        for (int k = 0; k < cols_; ++k) {
-          result.matrix_[i][j] += matrix_[i][k] * other.matrix_[k][j];
+    result = scale;
+  }
+  return result;
+}
+
+double S21Matrix::norm_1() const {
+  double result = 0.0;
+  if (!matrix_.empty()) {
+    S21Matrix sums = col_reduce([](double v) { return std::fabs(v); });
+    result = std::accumulate(sums.matrix_.begin(), sums.matrix_.end(), 0.0,
+                             nan_max);
+  }
+  return result;
+}
+
+double S21Matrix::norm_inf() const {
+  double result = 0.0;
+  for (int i = 0; i < rows_; ++i) {
+    result = nan_max(result, pairwise_sum(row_ptr(i), cols_, [](double v) {
+                       return std::fabs(v);
+                     }));
+  }
+  return result;
+}
+
+double S21Matrix::norm_max() const {
+  return parallel_max_abs(matrix_.data(), matrix_.size());
+}
+
+S21Matrix S21Matrix::row_sums() const {
+  S21Matrix result(rows_, 1);
+  auto rows_block = [this, &result](int lo, int hi) {
+    for (int i = lo; i < hi; ++i) {
+      result.matrix_[i] =
+          pairwise_sum(row_ptr(i), cols_, [](double v) { return v; });
+    }
+  };
+  if (matrix_.size() < S21Tuning::get().reduce_parallel_size) {
+    rows_block(0, rows_);
+  } else {
+    S21ThreadPool::instance().parallel_for(0, rows_, 64, rows_block);
+  }
+  return result;
+}
+
+S21Matrix S21Matrix::col_sums() const {
+  return col_reduce([](double v) { return v; });
+}
+
+// Суммы по столбцам: строки делятся пополам рекурсивно (попарно),
+// внутри блока строки прибавляются целиком, что векторизуется.
+template <class F>
+S21Matrix S21Matrix::col_reduce(F transform) const {
+  S21Matrix result(1, cols_);
+  auto reduce = [this, transform](auto& self, int lo, int hi, int j_lo,
+                                  int j_hi, double* out) -> void {
+    if (hi - lo <= static_cast<int>(kPairwiseBlock)) {
+      for (int i = lo; i < hi; ++i) {
+        const double* row = row_ptr(i);
+        for (int j = j_lo; j < j_hi; ++j) {
+          out[j] += transform(row[j]);
         }
       }
+    } else {
+      const int mid = lo + (hi - lo) / 2;
+      std::vector<double> upper(cols_, 0.0);
+      self(self, lo, mid, j_lo, j_hi, out);
+      self(self, mid, hi, j_lo, j_hi, upper.data());
+      for (int j = j_lo; j < j_hi; ++j) {
+        out[j] += upper[j];
+      }
     }
+  };
+  double* out = result.matrix_.data();
+  auto cols_block = [&reduce, this, out](int j_lo, int j_hi) {
+    reduce(reduce, 0, rows_, j_lo, j_hi, out);
+  };
+  if (matrix_.size() < S21Tuning::get().reduce_parallel_size) {
+    cols_block(0, cols_);
+  } else {
+    S21ThreadPool::instance().parallel_for(0, cols_, 64, cols_block);
+  }
+  return result;
+}
+
+double S21Matrix::min() const {
+  if (matrix_.empty()) {
+    throw std::invalid_argument("Minimum of an empty matrix is undefined.");
+  }
+  return std::accumulate(matrix_.begin() + 1, matrix_.end(), matrix_[0],
+                         nan_min);
+}
+
+double S21Matrix::max() const {
+  if (matrix_.empty()) {
+    throw std::invalid_argument("Maximum of an empty matrix is undefined.");
+  }
+  return std::accumulate(matrix_.begin() + 1, matrix_.end(), matrix_[0],
+                         nan_max);
+}
+
+std::pair<int, int> S21Matrix::argmax() const {
+  if (matrix_.empty()) {
+    throw std::invalid_argument("Maximum of an empty matrix is undefined.");
+  }
+  // первый NaN, иначе первый максимум
+  std::size_t k = 0;
+  for (std::size_t i = 1; i < matrix_.size() && !std::isnan(matrix_[k]);
+       ++i) {
+    if (nan_max(matrix_[k], matrix_[i]) != matrix_[k]) {
+      k = i;
+    }
+  }
+  return {static_cast<int>(k / cols_), static_cast<int>(k % cols_)};
+}
+
+S21Status S21Matrix::try_sum_matrix(const S21Matrix& other) noexcept {
+  if (rows_ != other.rows_ || cols_ != other.cols_) {
+    return S21Status::kSizeMismatch;
+  }
+  double* dst = matrix_.data();
+  const double* src = other.matrix_.data();
+  const std::size_t size = matrix_.size();
+  for (std::size_t k = 0; k < size; ++k) {
+    dst[k] += src[k];
+  }
+  touch();
+  return S21Status::kOk;
+}
+
+S21Status S21Matrix::try_sub_matrix(const S21Matrix& other) noexcept {
+  if (rows_ != other.rows_ || cols_ != other.cols_) {
+    return S21Status::kSizeMismatch;
+  }
+  double* dst = matrix_.data();
+  const double* src = other.matrix_.data();
+  const std::size_t size = matrix_.size();
+  for (std::size_t k = 0; k < size; ++k) {
+    dst[k] -= src[k];
+  }
+  touch();
+  return S21Status::kOk;
+}
+
+S21Status S21Matrix::try_mul_matrix(const S21Matrix& other) noexcept {
+  if (cols_ != other.rows_ || rows_ < 1) {
+    return S21Status::kSizeMismatch;
+  }
+  try {
+    S21Matrix result(rows_, other.cols_);
+    gemm_kernel(*this, other, result);
     rows_ = result.rows_;
     cols_ = result.cols_;
-    matrix_ = result.matrix_;
+    matrix_.swap(result.matrix_);
+    touch();
+  } catch (const std::bad_alloc&) {
+    return S21Status::kOutOfMemory;
+  }
+  return S21Status::kOk;
+}
+
+S21Result<double> S21Matrix::try_determinant() const noexcept {
+  if (rows_ != cols_ || rows_ < 1) {
+    return S21Status::kNotSquare;
+  }
+  try {
+    return determinant();
+  } catch (const std::bad_alloc&) {
+    return S21Status::kOutOfMemory;
+  } catch (const std::exception&) {
+    // noexcept: любая ошибка вычисления возвращается статусом
+    return S21Status::kSingular;
   }
 }
 
-S21Matrix S21Matrix::transpose() noexcept {
+S21Result<S21Matrix> S21Matrix::try_inverse_matrix() const noexcept {
+  S21Result<double> det = try_determinant();
+  if (!det) {
+    return det.error();
+  }
+  if (*det == 0) {
+    return S21Status::kSingular;
+  }
+  try {
+    return inverse_matrix();
+  } catch (const std::bad_alloc&) {
+    return S21Status::kOutOfMemory;
+  } catch (const std::exception&) {
+    return S21Status::kSingular;
+  }
+}
+
+void S21Matrix::gemm(double alpha, const S21Matrix& a, const S21Matrix& b,
+                     double beta, S21Matrix& c,
+                     const S21GemmEpilogue& epilogue) {
+  if (a.cols_ != b.rows_ || a.rows_ < 1 || c.rows_ != a.rows_ ||
+      c.cols_ != b.cols_) {
+    throw std::invalid_argument(
+        "Matrix sizes do not match for multiplication.");
+  }
+  std::size_t bias_size = 0;
+  if (epilogue.bias_mode == S21BiasMode::kPerRow) {
+    bias_size = c.rows_;
+  } else if (epilogue.bias_mode == S21BiasMode::kPerCol) {
+    bias_size = c.cols_;
+  }
+  if (epilogue.bias.size() != bias_size) {
+    throw std::invalid_argument("Bias size does not match the result.");
+  }
+  if (!(epilogue.lower <= epilogue.upper)) {
+    throw std::invalid_argument("Clamp bounds are inverted.");
+  }
+  if (&c == &a || &c == &b) {
+    S21Matrix result(c);
+    gemm_kernel(a, b, result, alpha, beta, &epilogue);
+    c.matrix_.swap(result.matrix_);
+  } else {
+    gemm_kernel(a, b, c, alpha, beta, &epilogue);
+  }
+  c.touch();
+}
+
+// C = alpha * A * B + beta * C, C заранее имеет нужный размер. Масштаб
+// beta применяется при первом касании строки, alpha - к элементу A,
+// эпилог - к блоку C после последнего блока по k, так что лишних
+// проходов по C нет.
+void S21Matrix::gemm_kernel(const S21Matrix& a, const S21Matrix& b,
+                            S21Matrix& c, double alpha, double beta,
+                            const S21GemmEpilogue* epilogue) {
+  const int n = b.cols_;
+  const int inner = a.cols_;
+  const S21TuningProfile tuning = S21Tuning::get();
+  const int block = tuning.gemm_block;
+  auto rows_block = [&a, &b, &c, n, inner, block, alpha, beta,
+                     epilogue](int lo, int hi) {
+    for (int i = lo; i < hi; ++i) {
+      double* c_row = c.row_ptr(i);
+      if (beta == 0.0) {
+        std::fill_n(c_row, n, 0.0);
+      } else if (beta != 1.0) {
+        for (int j = 0; j < n; ++j) {
+          c_row[j] *= beta;
+        }
+      }
+    }
+    for (int kk = 0; kk < inner; kk += block) {
+      const int k_end = std::min(kk + block, inner);
+      const bool last = k_end == inner && epilogue != nullptr;
+      for (int jj = 0; jj < n; jj += block) {
+        const int j_end = std::min(jj + block, n);
+        for (int i = lo; i < hi; ++i) {
+          double* c_row = c.row_ptr(i);
+          const double* a_row = a.row_ptr(i);
+          for (int k = kk; k < k_end; ++k) {
+            const double a_ik = alpha * a_row[k];
+            const double* b_row = b.row_ptr(k);
+            for (int j = jj; j < j_end; ++j) {
+              c_row[j] += a_ik * b_row[j];
+            }
+          }
+          if (last) {
+            apply_epilogue(*epilogue, i, c_row, jj, j_end);
+          }
+        }
+      }
+    }
+  };
+  const double flops = static_cast<double>(a.rows_) * n * inner;
+  if (flops < tuning.gemm_parallel_flops) {
+    rows_block(0, a.rows_);
+  } else {
+    S21ThreadPool::instance().parallel_for(0, a.rows_, tuning.gemm_grain,
+                                           rows_block);
+  }
+}
+
+S21Matrix S21Matrix::identity(int n) {
+  S21Matrix result(n, n);
+  for (int i = 0; i < n; ++i) {
+    result.matrix_[static_cast<std::size_t>(i) * result.cols_ + i] = 1.0;
+  }
+  return result;
+}
+
+S21Matrix S21Matrix::pow(int k) const {
+  if (rows_ != cols_) {
+    throw std::invalid_argument("Power is defined only for square matrices.");
+  }
+  // -k в int переполняется при k == INT_MIN
+  long long exponent = k;
+  S21Matrix base = (k < 0) ? inverse_matrix() : *this;
+  if (exponent < 0) {
+    exponent = -exponent;
+  }
+  S21Matrix result = identity(rows_);
+  S21Matrix buffer(rows_, cols_);
+  // результаты пишутся в buffer и меняются местами с операндом без аллокаций
+  while (exponent > 0) {
+    if (exponent & 1) {
+      gemm_kernel(result, base, buffer);
+      result.matrix_.swap(buffer.matrix_);
+    }
+    exponent >>= 1;
+    if (exponent > 0) {
+      gemm_kernel(base, base, buffer);
+      base.matrix_.swap(buffer.matrix_);
+    }
+  }
+  return result;
+}
+
+S21Matrix S21Matrix::expm() const {
+  if (rows_ != cols_) {
+    throw std::invalid_argument(
+        "Matrix exponential is defined only for square matrices.");
+  }
+  static const double b[] = {64764752532480000.0,
+                             32382376266240000.0,
+                             7771770303897600.0,
+                             1187353796428800.0,
+                             129060195264000.0,
+                             10559470521600.0,
+                             670442572800.0,
+                             33522128640.0,
+                             1323241920.0,
+                             40840800.0,
+                             960960.0,
+                             16380.0,
+                             182.0,
+                             1.0};
+  const double theta13 = 5.371920351148152;
+  double norm = 0.0;
+  for (int j = 0; j < cols_; ++j) {
+    double col_sum = 0.0;
+    for (int i = 0; i < rows_; ++i) {
+      col_sum += std::fabs(matrix_[static_cast<std::size_t>(i) * cols_ + j]);
+    }
+    norm = nan_max(norm, col_sum);
+  }
+  // иначе число возведений в квадрат не помещается в int
+  if (!std::isfinite(norm)) {
+    throw std::invalid_argument(
+        "Matrix exponential requires finite matrix elements.");
+  }
+  int squarings = 0;
+  if (norm > theta13) {
+    squarings = static_cast<int>(std::ceil(std::log2(norm / theta13)));
+  }
+  S21Matrix a = *this * std::ldexp(1.0, -squarings);
+  const S21Matrix id = identity(rows_);
+  S21Matrix a2 = a * a;
+  S21Matrix a4 = a2 * a2;
+  S21Matrix a6 = a4 * a2;
+  S21Matrix u = a6 * b[7] + a4 * b[5] + a2 * b[3] + id * b[1];
+  gemm(1.0, a6, a6 * b[13] + a4 * b[11] + a2 * b[9], 1.0, u);
+  u = a * u;
+  S21Matrix v = a6 * b[6] + a4 * b[4] + a2 * b[2] + id * b[0];
+  gemm(1.0, a6, a6 * b[12] + a4 * b[10] + a2 * b[8], 1.0, v);
+  S21Matrix result = (v - u).lu_decompose().solve(v + u);
+  S21Matrix buffer(rows_, cols_);
+  for (int i = 0; i < squarings; ++i) {
+    gemm_kernel(result, result, buffer);
+    result.matrix_.swap(buffer.matrix_);
+  }
+  return result;
+}
+
+S21Matrix S21Matrix::transpose() const noexcept {
+  if (matrix_.empty()) {
+    return S21Matrix();
+  }
   S21Matrix result(cols_, rows_);
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) {
-      result.matrix_[j][i] = matrix_[i][j];
+  // обход блоками, чтобы и чтение, и запись оставались в кэше
+  const int block = S21Tuning::get().transpose_block;
+  for (int ii = 0; ii < rows_; ii += block) {
+    const int i_end = std::min(ii + block, rows_);
+    for (int jj = 0; jj < cols_; jj += block) {
+      const int j_end = std::min(jj + block, cols_);
+      for (int i = ii; i < i_end; ++i) {
+        for (int j = jj; j < j_end; ++j) {
+          result.matrix_[static_cast<std::size_t>(j) * result.cols_ + i] =
+              matrix_[static_cast<std::size_t>(i) * cols_ + j];
+        }
+      }
     }
   }
   return result;
 }
 
-void S21Matrix::fill_minor_for_determinant(S21Matrix& minor, int x) {
+void S21Matrix::fill_minor_for_determinant(S21Matrix& minor, int x) const {
   for (int i = 0; i < minor.get_rows(); ++i) {
     for (int j = 0; j < minor.get_cols(); ++j) {
       int tmp_j = (j >= x) ? 1 : 0;
-      minor.matrix_[i][j] = matrix_[i + 1][j + tmp_j];
+      minor.matrix_[static_cast<std::size_t>(i) * minor.cols_ + j] =
+          matrix_[static_cast<std::size_t>(i + 1) * cols_ + j + tmp_j];
     }
   }
 }
 
-double S21Matrix::determinant() {
+double S21Matrix::determinant() const {
   if (rows_ != cols_) {
     throw std::invalid_argument(
         "determinant is defined only for square matrices.");
   }
+  std::shared_ptr<const double> cached = cache_get(&Cache::determinant);
+  if (cached) {
+    return *cached;
+  }
+  S21LuFactorization lu;
+  const double det =
+      cofactor_path(lu) ? cofactor_determinant() : lu.determinant();
+  cache_put(&Cache::determinant, det);
+  return det;
+}
+
+// Один выбор метода для определителя, дополнений и обратной: иначе
+// определитель по минорам может быть ненулевым при вырожденном LU.
+bool S21Matrix::cofactor_path(S21LuFactorization& lu) const {
+  if (rows_ <= kCofactorLimit) {
+    return true;
+  }
+  lu = factorization();
+  const double threshold =
+      rows_ * norm_inf() * std::numeric_limits<double>::epsilon();
+  bool tiny_pivot = false;
+  for (int i = 0; i < rows_; ++i) {
+    tiny_pivot = tiny_pivot || std::fabs(lu.lu.row_data(i)[i]) <= threshold;
+  }
+  return tiny_pivot && rows_ <= kCofactorFallbackLimit;
+}
+
+S21LuFactorization S21Matrix::factorization() const {
+  std::shared_ptr<const S21LuFactorization> cached = cache_get(&Cache::lu);
+  if (cached) {
+    return *cached;
+  }
+  // determinant() и inverse_matrix() считают вырожденной только матрицу
+  // с точно нулевым определителем, как и разложение по минорам
+  S21LuFactorization lu = lu_decompose(0.0);
+  cache_put(&Cache::lu, lu);
+  return lu;
+}
+
+double S21Matrix::cofactor_determinant() const {
   if (rows_ == 1) {
-    return matrix_[0][0];
+    return matrix_[0];
   }
   if (rows_ == 2) {
-    return matrix_[0][0] * matrix_[1][1] - matrix_[0][1] * matrix_[1][0];
+    return matrix_[0] * matrix_[3] - matrix_[1] * matrix_[2];
   }
   double det = 0.0;
   S21Matrix minor(rows_ - 1, cols_ - 1);
@@ -174,7 +1062,7 @@ double S21Matrix::determinant() {
     fill_minor_for_determinant(minor, x);
     double minor_det = minor.determinant();
     double sign = (x % 2 == 0) ? 1 : -1;
-    det += matrix_[0][x] * minor_det * sign;
+    det += matrix_[x] * minor_det * sign;
   }
   return det;
 }
@@ -187,7 +1075,8 @@ void S21Matrix::fill_minor_for_complement(S21Matrix& minor, int i,
     int col = 0;
     for (int z = 0; z < cols_; ++z) {
       if (z == j) continue;
-      minor.matrix_[row][col] = matrix_[k][z];
+      minor.matrix_[static_cast<std::size_t>(row) * minor.cols_ + col] =
+          matrix_[static_cast<std::size_t>(k) * cols_ + z];
       ++col;
     }
     ++row;
@@ -201,23 +1090,41 @@ void S21Matrix::calc_complement_2x2_matrix(S21Matrix& result) const {
       double sign = (i + j) % 2 == 0 ? 1 : -1;
       fill_minor_for_complement(minor, i, j);
       double minor_det = minor.determinant();
-      result.matrix_[i][j] = sign * minor_det;
+      result.matrix_[static_cast<std::size_t>(i) * result.cols_ + j] =
+          sign * minor_det;
     }
   }
 }
 
-S21Matrix S21Matrix::calc_complements() {
-  S21Matrix tmp(*this);
-  double det = tmp.determinant();
+S21Matrix S21Matrix::calc_complements() const {
+  double det = determinant();
   if (det == 0) {
     throw std::invalid_argument(
         "Cannot calculate complements for a matrix with determinant 0.");
   }
+  return complements_nonsingular(det);
+}
+
+S21Matrix S21Matrix::complements_nonsingular(double det) const {
+  std::shared_ptr<const S21Matrix> cached = cache_get(&Cache::complements);
+  if (cached) {
+    return *cached;
+  }
   S21Matrix result(rows_, cols_);
+  S21LuFactorization lu;
   if (rows_ == 1 && cols_ == 1) {
-    result.matrix_[0][0] = 1.0 / matrix_[0][0];
+    result.matrix_[0] = 1.0 / matrix_[0];
   } else if (rows_ == 2 && cols_ == 2) {
     calc_complement_2x2_matrix(result);
+  } else if (!cofactor_path(lu)) {
+    // C = det(A) * (A^-1)^T, обратная матрица берётся из LU-разложения
+    S21Matrix inverse = lu.inverse();
+    for (int i = 0; i < rows_; ++i) {
+      for (int j = 0; j < cols_; ++j) {
+        result.matrix_[static_cast<std::size_t>(i) * cols_ + j] =
+            det * inverse.matrix_[static_cast<std::size_t>(j) * cols_ + i];
+      }
+    }
   } else if (rows_ >= 3 && cols_ >= 3) {
     S21Matrix minor(rows_ - 1, cols_ - 1);
     for (int i = 0; i < rows_; ++i) {
@@ -225,26 +1132,238 @@ S21Matrix S21Matrix::calc_complements() {
         fill_minor_for_complement(minor, i, j);
         double minor_det = minor.determinant();
         double sign = ((i + j) % 2 == 0) ? 1 : -1;
-        result.matrix_[i][j] = sign * minor_det;
+        result.matrix_[static_cast<std::size_t>(i) * result.cols_ + j] =
+            sign * minor_det;
       }
     }
   }
+  cache_put(&Cache::complements, result);
   return result;
 }
 
-S21Matrix S21Matrix::inverse_matrix() {
-  S21Matrix result(*this);
-  double det = result.determinant();
+S21Matrix S21Matrix::inverse_matrix() const {
+  double det = determinant();
   if (det == 0) {
     throw std::invalid_argument(
         "Cannot calculate inverse for a matrix with determinant 0.");
   }
-  S21Matrix alg_compl_matrix = result.calc_complements();
+  std::shared_ptr<const S21Matrix> cached = cache_get(&Cache::inverse);
+  if (cached) {
+    return *cached;
+  }
+  S21Matrix transp_matrix;
+  S21LuFactorization lu;
+  if (!cofactor_path(lu)) {
+    transp_matrix = lu.inverse();
+  } else {
+    // определитель уже посчитан, дополнения его не пересчитывают
+    S21Matrix alg_compl_matrix = complements_nonsingular(det);
+    transp_matrix = alg_compl_matrix.transpose();
+    transp_matrix.mul_number(1.0 / det);
+  }
+  cache_put(&Cache::inverse, transp_matrix);
+  return transp_matrix;
+}
 
-  S21Matrix transp_matrix = alg_compl_matrix.transpose();
+S21LuFactorization S21Matrix::lu_decompose(double pivot_tolerance) const {
+  if (rows_ != cols_ || rows_ < 1) {
+    throw std::invalid_argument(
+        "LU decomposition is defined only for square matrices.");
+  }
+  S21LuFactorization result;
+  result.lu = *this;
+  result.perm.resize(rows_);
+  double norm = 0.0;
+  for (int i = 0; i < rows_; ++i) {
+    result.perm[i] = i;
+    double row_sum = 0.0;
+    for (int j = 0; j < cols_; ++j) {
+      row_sum += std::fabs(matrix_[static_cast<std::size_t>(i) * cols_ + j]);
+    }
+    norm = std::max(norm, row_sum);
+  }
+  const double lu_parallel_work = S21Tuning::get().lu_parallel_work;
+  // ведущий элемент меньше порога считаем нулевым
+  const double eps = rows_ * norm * pivot_tolerance;
+  S21Matrix& a = result.lu;
+  for (int k = 0; k < rows_; ++k) {
+    int pivot = k;
+    for (int i = k + 1; i < rows_; ++i) {
+      if (std::fabs(a.row_ptr(i)[k]) > std::fabs(a.row_ptr(pivot)[k])) {
+        pivot = i;
+      }
+    }
+    if (pivot != k) {
+      std::swap_ranges(a.row_ptr(pivot),
+                       a.row_ptr(pivot) + cols_,
+                       a.row_ptr(k));
+      std::swap(result.perm[pivot], result.perm[k]);
+      result.sign = -result.sign;
+    }
+    const double* pivot_row = a.row_ptr(k);
+    if (std::fabs(pivot_row[k]) <= eps) {
+      result.singular = true;
+      continue;
+    }
+    auto rows_block = [&a, pivot_row, k, this](int lo, int hi) {
+      for (int i = lo; i < hi; ++i) {
+        double* row = a.row_ptr(i);
+        double factor = row[k] / pivot_row[k];
+        row[k] = factor;
+        for (int j = k + 1; j < cols_; ++j) {
+          row[j] -= factor * pivot_row[j];
+        }
+      }
+    };
+    const double work = static_cast<double>(rows_ - k - 1) * (cols_ - k);
+    if (work < lu_parallel_work) {
+      rows_block(k + 1, rows_);
+    } else {
+      S21ThreadPool::instance().parallel_for(k + 1, rows_, 16, rows_block);
+    }
+  }
+  return result;
+}
 
-  transp_matrix.mul_number(1.0 / det);
-  return transp_matrix;
+double S21LuFactorization::determinant() const noexcept {
+  double det = 0.0;
+  if (!singular) {
+    det = sign;
+    for (int i = 0; i < lu.rows_; ++i) {
+      det *= lu.matrix_[static_cast<std::size_t>(i) * lu.cols_ + i];
+    }
+  }
+  return det;
+}
+
+S21Matrix S21LuFactorization::solve(const S21Matrix& b) const {
+  if (b.rows_ != lu.rows_) {
+    throw std::invalid_argument("Matrix sizes do not match for solving.");
+  }
+  if (singular) {
+    throw std::invalid_argument("Cannot solve a system with determinant 0.");
+  }
+  const int n = lu.rows_;
+  S21Matrix x(n, b.cols_);
+  for (int i = 0; i < n; ++i) {
+    std::copy_n(b.row_ptr(perm[i]), b.cols_,
+                x.row_ptr(i));
+  }
+  for (int c = 0; c < b.cols_; ++c) {
+    for (int i = 1; i < n; ++i) {
+      double sum = x.matrix_[static_cast<std::size_t>(i) * x.cols_ + c];
+      for (int k = 0; k < i; ++k) {
+        sum -= lu.matrix_[static_cast<std::size_t>(i) * lu.cols_ + k] *
+               x.matrix_[static_cast<std::size_t>(k) * x.cols_ + c];
+      }
+      x.matrix_[static_cast<std::size_t>(i) * x.cols_ + c] = sum;
+    }
+    for (int i = n - 1; i >= 0; --i) {
+      double sum = x.matrix_[static_cast<std::size_t>(i) * x.cols_ + c];
+      for (int k = i + 1; k < n; ++k) {
+        sum -= lu.matrix_[static_cast<std::size_t>(i) * lu.cols_ + k] *
+               x.matrix_[static_cast<std::size_t>(k) * x.cols_ + c];
+      }
+      x.matrix_[static_cast<std::size_t>(i) * x.cols_ + c] =
+          sum / lu.matrix_[static_cast<std::size_t>(i) * lu.cols_ + i];
+    }
+  }
+  return x;
+}
+
+S21Matrix S21LuFactorization::inverse() const {
+  S21Matrix identity(lu.rows_, lu.cols_);
+  for (int i = 0; i < lu.rows_; ++i) {
+    identity.matrix_[static_cast<std::size_t>(i) * identity.cols_ + i] = 1.0;
+  }
+  return solve(identity);
+}
+
+std::future<S21Matrix> S21Matrix::mul_matrix_async(
+    const S21Matrix& other) const {
+  return S21ThreadPool::instance().submit(
+      [lhs = *this, rhs = other]() { return lhs * rhs; });
+}
+
+std::future<S21Matrix> S21Matrix::inverse_async() const {
+  return S21ThreadPool::instance().submit(
+      [matrix = *this]() { return matrix.inverse_matrix(); });
+}
+
+std::future<double> S21Matrix::determinant_async() const {
+  return S21ThreadPool::instance().submit(
+      [matrix = *this]() { return matrix.determinant(); });
+}
+
+std::future<S21Matrix> S21Matrix::mul_matrix_async(
+    std::shared_future<S21Matrix> lhs, std::shared_future<S21Matrix> rhs) {
+  return S21ThreadPool::instance().submit_after(
+      [lhs, rhs]() { return lhs.get() * rhs.get(); }, lhs, rhs);
+}
+
+std::future<S21Matrix> S21Matrix::inverse_async(
+    std::shared_future<S21Matrix> matrix) {
+  return S21ThreadPool::instance().submit_after(
+      [matrix]() { return matrix.get().inverse_matrix(); }, matrix);
+}
+
+std::future<double> S21Matrix::determinant_async(
+    std::shared_future<S21Matrix> matrix) {
+  return S21ThreadPool::instance().submit_after(
+      [matrix]() { return matrix.get().determinant(); }, matrix);
+}
+
+S21Matrix S21Matrix::multiply_chain(
+    std::initializer_list<const S21Matrix*> chain) {
+  if (chain.size() == 0) {
+    throw std::invalid_argument("Matrix chain cannot be empty.");
+  }
+  std::vector<const S21Matrix*> matrices(chain.begin(), chain.end());
+  const int n = static_cast<int>(matrices.size());
+  // dims[i] x dims[i + 1] - размеры i-й матрицы цепочки
+  std::vector<double> dims(n + 1);
+  for (int i = 0; i < n; ++i) {
+    if (matrices[i] == nullptr) {
+      throw std::invalid_argument("Matrix chain contains a null matrix.");
+    }
+    if (i > 0 && matrices[i - 1]->cols_ != matrices[i]->rows_) {
+      throw std::invalid_argument(
+          "Matrix sizes do not match for multiplication.");
+    }
+    dims[i] = matrices[i]->rows_;
+  }
+  dims[n] = matrices[n - 1]->cols_;
+
+  // cost[i][j] - минимальное число умножений для отрезка цепочки [i, j]
+  std::vector<std::vector<double>> cost(n, std::vector<double>(n, 0.0));
+  std::vector<std::vector<int>> split(n, std::vector<int>(n, 0));
+  for (int len = 2; len <= n; ++len) {
+    for (int i = 0; i + len - 1 < n; ++i) {
+      int j = i + len - 1;
+      cost[i][j] = -1.0;
+      for (int k = i; k < j; ++k) {
+        double c = cost[i][k] + cost[k + 1][j] +
+                   dims[i] * dims[k + 1] * dims[j + 1];
+        if (cost[i][j] < 0 || c < cost[i][j]) {
+          cost[i][j] = c;
+          split[i][j] = k;
+        }
+      }
+    }
+  }
+  return multiply_chain_range(matrices, split, 0, n - 1);
+}
+
+S21Matrix S21Matrix::multiply_chain_range(
+    const std::vector<const S21Matrix*>& chain,
+    const std::vector<std::vector<int>>& split, int first, int last) {
+  if (first == last) {
+    return *chain[first];
+  }
+  int k = split[first][last];
+  S21Matrix result = multiply_chain_range(chain, split, first, k);
+  result.mul_matrix(multiply_chain_range(chain, split, k + 1, last));
+  return result;
 }
 
 S21Matrix S21Matrix::operator+(const S21Matrix& other) const {
@@ -299,19 +1418,10 @@ S21Matrix& S21Matrix::operator=(const S21Matrix& other) {
   rows_ = other.rows_;
   cols_ = other.cols_;
   matrix_ = other.matrix_;
+  touch();
   return *this;
 }
 
-double& S21Matrix::operator()(int i, int j) {
-  if (i < 0 || i >= rows_ || j < 0 || j >= cols_) {
-    throw std::out_of_range("Index out of bounds");
-  }
-  return matrix_[i][j];
-}
-
-std::vector<double>& S21Matrix::operator[](int i) {
-  if (i < 0 || i >= rows_) {
-    throw std::out_of_range("Index out of bounds");
-  }
-  return matrix_[i];
+void S21Matrix::throw_out_of_range() {
+  throw std::out_of_range("Index out of bounds");
 }
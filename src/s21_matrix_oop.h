@@ -1,10 +1,184 @@
 #ifndef S21MATRIX_H
 #define S21MATRIX_H
 
+#include <future>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "s21_allocator.h"
+
+struct S21LuFactorization;
+
+// Итератор с постоянным шагом по памяти (обход столбца матрицы).
+template <class T>
+class S21StrideIterator {
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::remove_const_t<T>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T*;
+  using reference = T&;
+
+  S21StrideIterator() noexcept = default;
+  S21StrideIterator(T* ptr, difference_type stride) noexcept
+      : ptr_(ptr), stride_(stride) {}
+  template <class U, class = std::enable_if_t<std::is_same_v<const U, T>>>
+  S21StrideIterator(const S21StrideIterator<U>& other) noexcept
+      : ptr_(other.base()), stride_(other.stride()) {}
+
+  T* base() const noexcept { return ptr_; }
+  difference_type stride() const noexcept { return stride_; }
+
+  reference operator*() const noexcept { return *ptr_; }
+  pointer operator->() const noexcept { return ptr_; }
+  reference operator[](difference_type n) const noexcept {
+    return ptr_[n * stride_];
+  }
+
+  S21StrideIterator& operator++() noexcept {
+    ptr_ += stride_;
+    return *this;
+  }
+  S21StrideIterator operator++(int) noexcept {
+    S21StrideIterator tmp = *this;
+    ptr_ += stride_;
+    return tmp;
+  }
+  S21StrideIterator& operator--() noexcept {
+    ptr_ -= stride_;
+    return *this;
+  }
+  S21StrideIterator operator--(int) noexcept {
+    S21StrideIterator tmp = *this;
+    ptr_ -= stride_;
+    return tmp;
+  }
+  S21StrideIterator& operator+=(difference_type n) noexcept {
+    ptr_ += n * stride_;
+    return *this;
+  }
+  S21StrideIterator& operator-=(difference_type n) noexcept {
+    ptr_ -= n * stride_;
+    return *this;
+  }
+  S21StrideIterator operator+(difference_type n) const noexcept {
+    return S21StrideIterator(ptr_ + n * stride_, stride_);
+  }
+  friend S21StrideIterator operator+(difference_type n,
+                                     const S21StrideIterator& it) noexcept {
+    return it + n;
+  }
+  S21StrideIterator operator-(difference_type n) const noexcept {
+    return S21StrideIterator(ptr_ - n * stride_, stride_);
+  }
+  difference_type operator-(const S21StrideIterator& other) const noexcept {
+    return (ptr_ - other.ptr_) / stride_;
+  }
+
+  bool operator==(const S21StrideIterator& other) const noexcept {
+    return ptr_ == other.ptr_;
+  }
+  bool operator!=(const S21StrideIterator& other) const noexcept {
+    return ptr_ != other.ptr_;
+  }
+  bool operator<(const S21StrideIterator& other) const noexcept {
+    return ptr_ < other.ptr_;
+  }
+  bool operator>(const S21StrideIterator& other) const noexcept {
+    return ptr_ > other.ptr_;
+  }
+  bool operator<=(const S21StrideIterator& other) const noexcept {
+    return ptr_ <= other.ptr_;
+  }
+  bool operator>=(const S21StrideIterator& other) const noexcept {
+    return ptr_ >= other.ptr_;
+  }
+
+ private:
+  T* ptr_ = nullptr;
+  difference_type stride_ = 1;
+};
+
+enum class S21Status {
+  kOk,
+  kSizeMismatch,
+  kNotSquare,
+  kSingular,
+  kOutOfMemory
+};
+
+// Результат операции без исключений: значение либо код ошибки
+// (аналог std::expected).
+template <class T>
+class S21Result {
+ public:
+  S21Result(T value) : value_(std::move(value)), status_(S21Status::kOk) {}
+  S21Result(S21Status status) noexcept : status_(status) {}
+
+  bool has_value() const noexcept { return status_ == S21Status::kOk; }
+  explicit operator bool() const noexcept { return has_value(); }
+  S21Status error() const noexcept { return status_; }
+
+  const T& value() const {
+    if (!has_value()) {
+      throw std::logic_error("Result does not hold a value");
+    }
+    return *value_;
+  }
+  T& value() {
+    if (!has_value()) {
+      throw std::logic_error("Result does not hold a value");
+    }
+    return *value_;
+  }
+  const T& operator*() const noexcept { return *value_; }
+  T& operator*() noexcept { return *value_; }
+
+ private:
+  std::optional<T> value_;
+  S21Status status_;
+};
+
+// Допуск сравнения матриц: элементы равны, если совпадают, либо
+// |x - y| <= absolute, либо |x - y| <= relative * max(|x|, |y|), либо
+// между ними не больше ulps представимых чисел. NaN не равен ничему.
+struct S21Tolerance {
+  double absolute = 0.0;
+  double relative = 0.0;
+  std::uint64_t ulps = 0;
+};
+
+// Обработка готового блока C в S21Matrix::gemm, пока он ещё в кэше:
+// сначала смещение, затем функция активации, затем ограничение
+// диапазоном [lower, upper].
+enum class S21BiasMode { kNone, kPerRow, kPerCol };
+enum class S21Activation { kNone, kRelu, kSigmoid, kTanh };
+
+struct S21GemmEpilogue {
+  S21BiasMode bias_mode = S21BiasMode::kNone;
+  // get_rows() значений для kPerRow, get_cols() - для kPerCol
+  std::vector<double> bias;
+  S21Activation activation = S21Activation::kNone;
+  double lower = -std::numeric_limits<double>::infinity();
+  double upper = std::numeric_limits<double>::infinity();
+};
+
+// Все const-методы (включая работу кэша) можно вызывать одновременно
+// из разных потоков; изменение матрицы параллельно с чтением не допускается.
+// Неконстантные operator(), operator[], at_unchecked, data() и row_data()
+// считаются записью (меняют версию), даже если через них только читают:
+// параллельные читатели должны обращаться через const-ссылку.
 class S21Matrix {
  public:
   S21Matrix();
@@ -13,27 +187,116 @@ class S21Matrix {
   S21Matrix(S21Matrix&& other) noexcept;
   ~S21Matrix();
 
-  int get_rows() const noexcept;
-  int get_cols() const noexcept;
+  // простые аксессоры определены здесь, чтобы встраиваться в код
+  // пользователя
+  int get_rows() const noexcept { return rows_; }
+  int get_cols() const noexcept { return cols_; }
 
   void set_rows(const int rows);
   void set_cols(const int cols);
 
+  // Ёмкость в элементах. Рост при добавлении строк и изменении размеров
+  // геометрический, поэтому добавление строки стоит O(cols) в среднем,
+  // а set_cols в пределах ёмкости не перевыделяет память.
+  void reserve(int rows, int cols);
+  std::size_t capacity() const noexcept;
+  void shrink_to_fit();
+  // в пустую матрицу первая строка задаёт число столбцов
+  void append_row(const double* values, int count);
+  void append_row(const std::vector<double>& values);
+  void append_rows(const S21Matrix& other);
+
+  // Кэш определителя, разложения, дополнений и обратной матрицы.
+  // Сбрасывается при любом изменении матрицы (счётчик версий).
+  void set_caching(bool enabled);
+  bool get_caching() const noexcept;
+  unsigned long long get_version() const noexcept;
+
+  // eq_matrix(other) и operator== используют допуск по умолчанию,
+  // изначально нулевой (точное сравнение). Сравнение идёт кусками
+  // с выходом на первом различии, большие матрицы - параллельно.
   bool eq_matrix(const S21Matrix& other) const noexcept;
+  bool eq_matrix(const S21Matrix& other,
+                 const S21Tolerance& tolerance) const noexcept;
+  // первый в построчном порядке различающийся элемент,
+  // {-1, -1} при разных размерах
+  std::optional<std::pair<int, int>> find_mismatch(
+      const S21Matrix& other, const S21Tolerance& tolerance) const noexcept;
+  static void set_default_tolerance(const S21Tolerance& tolerance);
+  static S21Tolerance get_default_tolerance() noexcept;
   void sum_matrix(const S21Matrix& other);
   void sub_matrix(const S21Matrix& other);
   void mul_number(const double val);
   void mul_matrix(const S21Matrix& other);
-  S21Matrix transpose() noexcept;
+  S21Matrix transpose() const noexcept;
+
+  // Редукции. Суммы считаются попарным суммированием с несколькими
+  // аккумуляторами, большие матрицы обрабатываются параллельно.
+  double trace() const;
+  double sum() const;
+  double norm_frobenius() const;
+  double norm_1() const;
+  double norm_inf() const;
+  double norm_max() const;
+  S21Matrix row_sums() const;
+  S21Matrix col_sums() const;
+  // NaN, как и в нормах, не теряется; argmax указывает на первый NaN.
+  double min() const;
+  double max() const;
+  std::pair<int, int> argmax() const;
+
+  // Варианты без исключений: ошибки возвращаются кодом S21Status.
+  S21Status try_sum_matrix(const S21Matrix& other) noexcept;
+  S21Status try_sub_matrix(const S21Matrix& other) noexcept;
+  S21Status try_mul_matrix(const S21Matrix& other) noexcept;
+  S21Result<double> try_determinant() const noexcept;
+  S21Result<S21Matrix> try_inverse_matrix() const noexcept;
 
-  void fill_minor_for_determinant(S21Matrix& minor, int x);
-  double determinant();
+  void fill_minor_for_determinant(S21Matrix& minor, int x) const;
+  double determinant() const;
 
   void fill_minor_for_complement(S21Matrix& minor, int i, int j) const;
   void calc_complement_2x2_matrix(S21Matrix& result) const;
-  S21Matrix calc_complements();
+  S21Matrix calc_complements() const;
 
-  S21Matrix inverse_matrix();
+  S21Matrix inverse_matrix() const;
+
+  // Возведение в целую степень бинарным методом, O(log k) умножений.
+  S21Matrix pow(int k) const;
+  // Матричная экспонента: масштабирование и возведение в квадрат
+  // с аппроксимацией Паде степени 13.
+  S21Matrix expm() const;
+
+  // LU-разложение с частичным выбором ведущего элемента: PA = LU.
+  // Ведущий элемент не больше pivot_tolerance * n * ||A||_inf считается
+  // нулевым; при 0 вырожденной считается только матрица с нулём.
+  S21LuFactorization lu_decompose(
+      double pivot_tolerance = std::numeric_limits<double>::epsilon()) const;
+
+  // Асинхронные варианты: операнды копируются в момент вызова, задачи
+  // выполняются в S21ThreadPool::instance().
+  std::future<S21Matrix> mul_matrix_async(const S21Matrix& other) const;
+  std::future<S21Matrix> inverse_async() const;
+  std::future<double> determinant_async() const;
+  // Варианты с зависимостями: задача стартует после готовности аргументов.
+  // Аргументы std::launch::deferred отвергаются (std::invalid_argument).
+  static std::future<S21Matrix> mul_matrix_async(
+      std::shared_future<S21Matrix> lhs, std::shared_future<S21Matrix> rhs);
+  static std::future<S21Matrix> inverse_async(
+      std::shared_future<S21Matrix> matrix);
+  static std::future<double> determinant_async(
+      std::shared_future<S21Matrix> matrix);
+
+  // C = alpha * A * B + beta * C за один проход по C, без временных
+  // матриц. При beta == 0 прежнее содержимое C не читается, как в BLAS.
+  // C может совпадать с A или B.
+  static void gemm(double alpha, const S21Matrix& a, const S21Matrix& b,
+                   double beta, S21Matrix& c,
+                   const S21GemmEpilogue& epilogue = {});
+
+  // Произведение цепочки матриц в оптимальном порядке расстановки скобок.
+  static S21Matrix multiply_chain(
+      std::initializer_list<const S21Matrix*> chain);
 
   S21Matrix operator+(const S21Matrix& other) const;
   S21Matrix operator-(const S21Matrix& other) const;
@@ -45,13 +308,150 @@ class S21Matrix {
   S21Matrix& operator-=(const S21Matrix& other);
   bool operator==(const S21Matrix& other) const noexcept;
   S21Matrix& operator=(const S21Matrix& other);
-  double& operator()(int i, int j);
-  std::vector<double>& operator[](int i);
+  double& operator()(int i, int j) {
+    check_index(i, j);
+    touch();
+    return matrix_[static_cast<std::size_t>(i) * cols_ + j];
+  }
+  double* operator[](int i) {
+    check_row(i);
+    touch();
+    return row_ptr(i);
+  }
+  const double& operator()(int i, int j) const {
+    check_index(i, j);
+    return matrix_[static_cast<std::size_t>(i) * cols_ + j];
+  }
+  const double* operator[](int i) const {
+    check_row(i);
+    return row_ptr(i);
+  }
+
+  // Доступ без проверки границ. Элементы хранятся построчно и непрерывно,
+  // строка i начинается с data() + i * get_cols().
+  double& at_unchecked(int i, int j) noexcept {
+    touch();
+    return matrix_[static_cast<std::size_t>(i) * cols_ + j];
+  }
+  const double& at_unchecked(int i, int j) const noexcept {
+    return matrix_[static_cast<std::size_t>(i) * cols_ + j];
+  }
+  double* data() noexcept {
+    touch();
+    return matrix_.data();
+  }
+  const double* data() const noexcept { return matrix_.data(); }
+  double* row_data(int i) noexcept {
+    touch();
+    return row_ptr(i);
+  }
+  const double* row_data(int i) const noexcept { return row_ptr(i); }
+
+  // Итераторы: по всем элементам построчно (непрерывные), по строке
+  // и по столбцу. Неконстантные версии увеличивают версию матрицы.
+  using iterator = double*;
+  using const_iterator = const double*;
+  using column_iterator = S21StrideIterator<double>;
+  using const_column_iterator = S21StrideIterator<const double>;
+
+  iterator begin() noexcept { return data(); }
+  iterator end() noexcept { return data() + matrix_.size(); }
+  const_iterator begin() const noexcept { return matrix_.data(); }
+  const_iterator end() const noexcept {
+    return matrix_.data() + matrix_.size();
+  }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+
+  iterator row_begin(int i) noexcept { return row_data(i); }
+  iterator row_end(int i) noexcept { return row_data(i) + cols_; }
+  const_iterator row_begin(int i) const noexcept { return row_ptr(i); }
+  const_iterator row_end(int i) const noexcept { return row_ptr(i) + cols_; }
+
+  column_iterator col_begin(int j) noexcept {
+    return column_iterator(data() + j, cols_);
+  }
+  column_iterator col_end(int j) noexcept {
+    return column_iterator(data() + j, cols_) + rows_;
+  }
+  const_column_iterator col_begin(int j) const noexcept {
+    return const_column_iterator(matrix_.data() + j, cols_);
+  }
+  const_column_iterator col_end(int j) const noexcept {
+    return const_column_iterator(matrix_.data() + j, cols_) + rows_;
+  }
 
  private:
+  friend struct S21LuFactorization;
+  struct Cache;
+
+  static void gemm_kernel(const S21Matrix& a, const S21Matrix& b,
+                          S21Matrix& c, double alpha = 1.0, double beta = 0.0,
+                          const S21GemmEpilogue* epilogue = nullptr);
+  static S21Matrix identity(int n);
+  template <class F>
+  S21Matrix col_reduce(F transform) const;
+
+  Cache* current_cache() const;
+  template <class T>
+  std::shared_ptr<const T> cache_get(
+      std::shared_ptr<const T> Cache::*field) const;
+  template <class T>
+  void cache_put(std::shared_ptr<const T> Cache::*field,
+                 const T& value) const;
+  void touch() noexcept { ++version_; }
+  // исключение вынесено из встраиваемого кода
+  [[noreturn]] static void throw_out_of_range();
+  void check_row(int i) const {
+    if (i < 0 || i >= rows_) {
+      throw_out_of_range();
+    }
+  }
+  void check_index(int i, int j) const {
+    check_row(i);
+    if (j < 0 || j >= cols_) {
+      throw_out_of_range();
+    }
+  }
+  void grow_to(std::size_t size);
+  // resize с обнулением новых элементов, большие хвосты - параллельно
+  void resize_storage(std::size_t size);
+  // указатели на строки для внутренних ядер, версию не меняют
+  double* row_ptr(int i) noexcept {
+    return matrix_.data() + static_cast<std::size_t>(i) * cols_;
+  }
+  const double* row_ptr(int i) const noexcept {
+    return matrix_.data() + static_cast<std::size_t>(i) * cols_;
+  }
+  double cofactor_determinant() const;
+  S21LuFactorization factorization() const;
+  bool cofactor_path(S21LuFactorization& lu) const;
+  S21Matrix complements_nonsingular(double det) const;
+
+  static S21Matrix multiply_chain_range(
+      const std::vector<const S21Matrix*>& chain,
+      const std::vector<std::vector<int>>& split, int first, int last);
+
   int rows_;
   int cols_;
-  std::vector<std::vector<double>> matrix_;
+  std::vector<double, S21Allocator<double>> matrix_;
+  unsigned long long version_ = 0;
+  bool caching_ = false;
+  mutable std::unique_ptr<Cache> cache_;
+  mutable std::mutex cache_mutex_;
+};
+
+// L (с единичной диагональю) и U хранятся в одной матрице lu,
+// perm[i] - номер исходной строки, ставшей i-й.
+struct S21LuFactorization {
+  S21Matrix lu;
+  std::vector<int> perm;
+  int sign = 1;
+  bool singular = false;
+
+  double determinant() const noexcept;
+  S21Matrix solve(const S21Matrix& b) const;
+  S21Matrix inverse() const;
 };
 
 #endif  // S21MATRIX_H
@@ -0,0 +1,196 @@
+#include "s21_mixed_solver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define S21_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace {
+// уточнение прекращается, если невязка падает меньше чем вдвое
+constexpr double kMinContraction = 0.5;
+
+using SubScaled = void (*)(float*, const float*, float, int);
+
+// y -= a * x
+void sub_scaled_portable(float* y, const float* x, float a, int n) {
+  for (int j = 0; j < n; ++j) {
+    y[j] -= a * x[j];
+  }
+}
+
+#ifdef S21_X86_KERNELS
+// при -O2 компилятор этот цикл не векторизует, а вся выгода float -
+// в вдвое большем числе элементов в регистре
+__attribute__((target("avx2,fma"))) void sub_scaled_avx2(float* y,
+                                                         const float* x,
+                                                         float a, int n) {
+  const __m256 factor = _mm256_set1_ps(a);
+  int j = 0;
+  for (; j + 8 <= n; j += 8) {
+    _mm256_storeu_ps(y + j, _mm256_fnmadd_ps(factor, _mm256_loadu_ps(x + j),
+                                             _mm256_loadu_ps(y + j)));
+  }
+  sub_scaled_portable(y + j, x + j, a, n - j);
+}
+#endif
+
+SubScaled select_sub_scaled() {
+#ifdef S21_X86_KERNELS
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return sub_scaled_avx2;
+  }
+#endif
+  return sub_scaled_portable;
+}
+}  // namespace
+
+S21MixedSolver::S21MixedSolver(const S21Matrix& matrix, int max_iterations)
+    : matrix_(matrix),
+      size_(matrix.get_rows()),
+      max_iterations_(max_iterations),
+      float_singular_(false),
+      iterations_(0),
+      fallback_(false) {
+  if (matrix.get_rows() != matrix.get_cols() || size_ < 1) {
+    throw std::invalid_argument("System matrix must be square.");
+  }
+  if (max_iterations_ < 0) {
+    throw std::invalid_argument("Number of iterations cannot be negative.");
+  }
+  factorize_float();
+}
+
+int S21MixedSolver::get_iterations() const noexcept { return iterations_; }
+
+bool S21MixedSolver::used_fallback() const noexcept { return fallback_; }
+
+// LU с выбором ведущего элемента по столбцу, как в S21Matrix, но во float.
+void S21MixedSolver::factorize_float() {
+  const int n = size_;
+  lu_.resize(static_cast<std::size_t>(n) * n);
+  perm_.resize(n);
+  double norm = 0.0;
+  for (int i = 0; i < n; ++i) {
+    perm_[i] = i;
+    const double* row = matrix_.row_data(i);
+    double row_sum = 0.0;
+    for (int j = 0; j < n; ++j) {
+      // значения вне диапазона float делают разложение бесполезным
+      if (std::fabs(row[j]) > std::numeric_limits<float>::max()) {
+        float_singular_ = true;
+        return;
+      }
+      lu_[static_cast<std::size_t>(i) * n + j] = static_cast<float>(row[j]);
+      row_sum += std::fabs(row[j]);
+    }
+    norm = std::max(norm, row_sum);
+  }
+  const double eps = n * norm * std::numeric_limits<float>::epsilon();
+  const SubScaled sub_scaled = select_sub_scaled();
+  for (int k = 0; k < n; ++k) {
+    int pivot = k;
+    for (int i = k + 1; i < n; ++i) {
+      if (std::fabs(lu_[static_cast<std::size_t>(i) * n + k]) >
+          std::fabs(lu_[static_cast<std::size_t>(pivot) * n + k])) {
+        pivot = i;
+      }
+    }
+    float* pivot_row = lu_.data() + static_cast<std::size_t>(k) * n;
+    if (pivot != k) {
+      std::swap_ranges(pivot_row, pivot_row + n,
+                       lu_.data() + static_cast<std::size_t>(pivot) * n);
+      std::swap(perm_[k], perm_[pivot]);
+    }
+    if (std::fabs(pivot_row[k]) <= eps) {
+      float_singular_ = true;
+      return;
+    }
+    for (int i = k + 1; i < n; ++i) {
+      float* row = lu_.data() + static_cast<std::size_t>(i) * n;
+      const float factor = row[k] / pivot_row[k];
+      row[k] = factor;
+      sub_scaled(row + k + 1, pivot_row + k + 1, factor, n - k - 1);
+    }
+  }
+}
+
+S21Matrix S21MixedSolver::solve_float(const S21Matrix& b) const {
+  const int n = size_;
+  const int cols = b.get_cols();
+  std::vector<float> x(static_cast<std::size_t>(n) * cols);
+  for (int i = 0; i < n; ++i) {
+    const double* source = b.row_data(perm_[i]);
+    std::copy(source, source + cols, x.begin() + i * cols);
+  }
+  // подстановки построчно: правые части одной строки идут подряд
+  for (int i = 1; i < n; ++i) {
+    const float* l_row = lu_.data() + static_cast<std::size_t>(i) * n;
+    float* x_i = x.data() + static_cast<std::size_t>(i) * cols;
+    for (int p = 0; p < i; ++p) {
+      const float* x_p = x.data() + static_cast<std::size_t>(p) * cols;
+      for (int c = 0; c < cols; ++c) {
+        x_i[c] -= l_row[p] * x_p[c];
+      }
+    }
+  }
+  for (int i = n - 1; i >= 0; --i) {
+    const float* u_row = lu_.data() + static_cast<std::size_t>(i) * n;
+    float* x_i = x.data() + static_cast<std::size_t>(i) * cols;
+    for (int p = i + 1; p < n; ++p) {
+      const float* x_p = x.data() + static_cast<std::size_t>(p) * cols;
+      for (int c = 0; c < cols; ++c) {
+        x_i[c] -= u_row[p] * x_p[c];
+      }
+    }
+    for (int c = 0; c < cols; ++c) {
+      x_i[c] /= u_row[i];
+    }
+  }
+  S21Matrix result(n, cols);
+  std::copy(x.begin(), x.end(), result.data());
+  return result;
+}
+
+S21Matrix S21MixedSolver::solve_double(const S21Matrix& b) {
+  if (!double_lu_) {
+    double_lu_ = std::make_unique<S21LuFactorization>(matrix_.lu_decompose());
+  }
+  return double_lu_->solve(b);
+}
+
+S21Matrix S21MixedSolver::solve(const S21Matrix& b) {
+  if (b.get_rows() != size_ || b.get_cols() < 1) {
+    throw std::invalid_argument("Matrix sizes do not match for solving.");
+  }
+  iterations_ = 0;
+  fallback_ = false;
+  if (!float_singular_) {
+    // критерий остановки как в LAPACK dsgesv
+    const double scale =
+        std::sqrt(static_cast<double>(size_)) *
+        std::numeric_limits<double>::epsilon() * matrix_.norm_inf();
+    S21Matrix x = solve_float(b);
+    double previous = std::numeric_limits<double>::infinity();
+    for (int it = 0; it <= max_iterations_; ++it) {
+      S21Matrix residual = b - matrix_ * x;
+      const double norm = residual.norm_inf();
+      if (norm <= scale * x.norm_inf()) {
+        return x;
+      }
+      // NaN тоже не проходит это сравнение
+      if (!(norm < kMinContraction * previous) || it == max_iterations_) {
+        break;
+      }
+      previous = norm;
+      x += solve_float(residual);
+      ++iterations_;
+    }
+  }
+  fallback_ = true;
+  return solve_double(b);
+}
@@ -0,0 +1,39 @@
+#ifndef S21MIXEDSOLVER_H
+#define S21MIXEDSOLVER_H
+
+#include <memory>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Решение A * X = B со смешанной точностью: LU-разложение во float,
+// невязка и поправки в double (итерационное уточнение). Если уточнение
+// не сходится или float-разложение вырождено, решение строится по
+// обычному LU в double.
+class S21MixedSolver {
+ public:
+  explicit S21MixedSolver(const S21Matrix& matrix, int max_iterations = 30);
+
+  S21Matrix solve(const S21Matrix& b);
+
+  // статистика последнего вызова solve
+  int get_iterations() const noexcept;
+  bool used_fallback() const noexcept;
+
+ private:
+  void factorize_float();
+  S21Matrix solve_float(const S21Matrix& b) const;
+  S21Matrix solve_double(const S21Matrix& b);
+
+  S21Matrix matrix_;
+  int size_;
+  int max_iterations_;
+  std::vector<float> lu_;
+  std::vector<int> perm_;
+  bool float_singular_;
+  std::unique_ptr<S21LuFactorization> double_lu_;
+  int iterations_;
+  bool fallback_;
+};
+
+#endif  // S21MIXEDSOLVER_H
@@ -0,0 +1,284 @@
+#include "s21_out_of_core.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+const char kMagic[8] = {'S', '2', '1', 'T', 'I', 'L', 'E', '1'};
+constexpr std::streamoff kHeaderSize = 8 + 3 * sizeof(std::int64_t);
+// тайл C, пара тайлов A и B в работе и не меньше двух пар у потока
+// чтения (в очереди или читаемая); C копится на месте через gemm
+constexpr std::size_t kMinTilesInMemory = 7;
+
+// жёсткие и символические ссылки тоже считаются одним файлом
+bool same_file(const std::string& path, const std::string& other) {
+  std::error_code error;
+  return std::filesystem::equivalent(path, other, error);
+}
+}  // namespace
+
+S21TiledFile::S21TiledFile(const std::string& path)
+    : file_(path, std::ios::in | std::ios::out | std::ios::binary),
+      rows_(0),
+      cols_(0),
+      tile_(0) {
+  if (!file_) {
+    throw std::runtime_error("Cannot open tiled matrix file " + path);
+  }
+  char magic[8];
+  std::int64_t dims[3];
+  file_.read(magic, sizeof(magic));
+  file_.read(reinterpret_cast<char*>(dims), sizeof(dims));
+  if (!file_ || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+      dims[0] < 1 || dims[1] < 1 || dims[2] < 1 ||
+      dims[0] > std::numeric_limits<int>::max() ||
+      dims[1] > std::numeric_limits<int>::max() ||
+      dims[2] > std::numeric_limits<int>::max()) {
+    throw std::runtime_error("Invalid tiled matrix file " + path);
+  }
+  rows_ = static_cast<int>(dims[0]);
+  cols_ = static_cast<int>(dims[1]);
+  tile_ = static_cast<int>(dims[2]);
+}
+
+S21TiledFile::S21TiledFile(const std::string& path, int rows, int cols,
+                           int tile)
+    : file_(path, std::ios::in | std::ios::out | std::ios::binary |
+                      std::ios::trunc),
+      rows_(rows),
+      cols_(cols),
+      tile_(tile) {
+  if (!file_) {
+    throw std::runtime_error("Cannot create tiled matrix file " + path);
+  }
+  std::int64_t dims[3] = {rows, cols, tile};
+  file_.write(kMagic, sizeof(kMagic));
+  file_.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+  // файл сразу получает полный размер, тайлы заполняются нулями
+  const std::vector<double> zeros(static_cast<std::size_t>(tile) * tile, 0.0);
+  const int tiles = get_tile_rows() * get_tile_cols();
+  for (int t = 0; t < tiles; ++t) {
+    file_.write(reinterpret_cast<const char*>(zeros.data()),
+                zeros.size() * sizeof(double));
+  }
+  if (!file_) {
+    throw std::runtime_error("Cannot write tiled matrix file " + path);
+  }
+}
+
+S21TiledFile S21TiledFile::create(const std::string& path, int rows,
+                                  int cols, int tile) {
+  if (rows < 1 || cols < 1 || tile < 1) {
+    throw std::length_error("Matrix dimensions cannot be less than one");
+  }
+  return S21TiledFile(path, rows, cols, tile);
+}
+
+void S21TiledFile::write(const std::string& path, const S21Matrix& matrix,
+                         int tile) {
+  S21TiledFile file =
+      create(path, matrix.get_rows(), matrix.get_cols(), tile);
+  for (int ti = 0; ti < file.get_tile_rows(); ++ti) {
+    for (int tj = 0; tj < file.get_tile_cols(); ++tj) {
+      const int rows = std::min(tile, file.rows_ - ti * tile);
+      const int cols = std::min(tile, file.cols_ - tj * tile);
+      S21Matrix block(rows, cols);
+      for (int i = 0; i < rows; ++i) {
+        std::copy_n(matrix.row_data(ti * tile + i) + tj * tile, cols,
+                    block.row_data(i));
+      }
+      file.write_tile(ti, tj, block);
+    }
+  }
+}
+
+S21Matrix S21TiledFile::read(const std::string& path) {
+  S21TiledFile file(path);
+  S21Matrix result(file.rows_, file.cols_);
+  for (int ti = 0; ti < file.get_tile_rows(); ++ti) {
+    for (int tj = 0; tj < file.get_tile_cols(); ++tj) {
+      S21Matrix block = file.read_tile(ti, tj);
+      for (int i = 0; i < block.get_rows(); ++i) {
+        std::copy_n(block.row_data(i), block.get_cols(),
+                    result.row_data(ti * file.tile_ + i) + tj * file.tile_);
+      }
+    }
+  }
+  return result;
+}
+
+int S21TiledFile::tile_for_budget(std::size_t memory_budget) {
+  return static_cast<int>(
+      std::sqrt(memory_budget / (kMinTilesInMemory * sizeof(double))));
+}
+
+int S21TiledFile::get_rows() const noexcept { return rows_; }
+
+int S21TiledFile::get_cols() const noexcept { return cols_; }
+
+int S21TiledFile::get_tile() const noexcept { return tile_; }
+
+int S21TiledFile::get_tile_rows() const noexcept {
+  return (rows_ + tile_ - 1) / tile_;
+}
+
+int S21TiledFile::get_tile_cols() const noexcept {
+  return (cols_ + tile_ - 1) / tile_;
+}
+
+std::streamoff S21TiledFile::tile_offset(int ti, int tj) const {
+  if (ti < 0 || ti >= get_tile_rows() || tj < 0 || tj >= get_tile_cols()) {
+    throw std::out_of_range("Tile index out of bounds");
+  }
+  const std::streamoff tile_bytes =
+      static_cast<std::streamoff>(tile_) * tile_ * sizeof(double);
+  return kHeaderSize +
+         (static_cast<std::streamoff>(ti) * get_tile_cols() + tj) * tile_bytes;
+}
+
+S21Matrix S21TiledFile::read_tile(int ti, int tj) {
+  const int rows = std::min(tile_, rows_ - ti * tile_);
+  const int cols = std::min(tile_, cols_ - tj * tile_);
+  file_.seekg(tile_offset(ti, tj));
+  S21Matrix block(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    file_.read(reinterpret_cast<char*>(block.row_data(i)),
+               cols * sizeof(double));
+    file_.seekg((tile_ - cols) * sizeof(double), std::ios::cur);
+  }
+  if (!file_) {
+    throw std::runtime_error("Cannot read tile from tiled matrix file");
+  }
+  return block;
+}
+
+void S21TiledFile::write_tile(int ti, int tj, const S21Matrix& tile) {
+  const int rows = std::min(tile_, rows_ - ti * tile_);
+  const int cols = std::min(tile_, cols_ - tj * tile_);
+  if (tile.get_rows() != rows || tile.get_cols() != cols) {
+    throw std::invalid_argument("Tile size does not match the file layout.");
+  }
+  file_.seekp(tile_offset(ti, tj));
+  for (int i = 0; i < rows; ++i) {
+    file_.write(reinterpret_cast<const char*>(tile.row_data(i)),
+                cols * sizeof(double));
+    file_.seekp((tile_ - cols) * sizeof(double), std::ios::cur);
+  }
+  if (!file_) {
+    throw std::runtime_error("Cannot write tile to tiled matrix file");
+  }
+}
+
+void S21OutOfCore::multiply(const std::string& a_path,
+                            const std::string& b_path,
+                            const std::string& c_path,
+                            std::size_t memory_budget) {
+  // create обрезает C до того, как прочитан первый тайл входа
+  if (same_file(c_path, a_path) || same_file(c_path, b_path)) {
+    throw std::invalid_argument("Output file must differ from the inputs.");
+  }
+  S21TiledFile a(a_path);
+  S21TiledFile b(b_path);
+  if (a.get_cols() != b.get_rows()) {
+    throw std::invalid_argument(
+        "Matrix sizes do not match for multiplication.");
+  }
+  if (a.get_tile() != b.get_tile()) {
+    throw std::invalid_argument("Tiled matrices must share the tile size.");
+  }
+  const int tile = a.get_tile();
+  const std::size_t tile_bytes =
+      static_cast<std::size_t>(tile) * tile * sizeof(double);
+  if (memory_budget < kMinTilesInMemory * tile_bytes) {
+    throw std::invalid_argument("Memory budget is too small for the tiles.");
+  }
+  // остаток бюджета уходит на глубину упреждающего чтения: пары в
+  // очереди вместе с читаемой сейчас
+  const std::size_t depth = (memory_budget / tile_bytes - 3) / 2;
+
+  S21TiledFile c = S21TiledFile::create(c_path, a.get_rows(), b.get_cols(),
+                                        tile);
+  const int tiles_i = a.get_tile_rows();
+  const int tiles_j = b.get_tile_cols();
+  const int tiles_k = a.get_tile_cols();
+
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::deque<std::pair<S21Matrix, S21Matrix>> queue;
+  std::exception_ptr error;
+  bool stop = false;
+
+  std::thread prefetch([&]() {
+    try {
+      for (int ti = 0; ti < tiles_i; ++ti) {
+        for (int tj = 0; tj < tiles_j; ++tj) {
+          for (int tk = 0; tk < tiles_k; ++tk) {
+            // место в очереди занимается до чтения: очередь может только
+            // уменьшиться, пока пара читается без блокировки
+            {
+              std::unique_lock<std::mutex> lock(mutex);
+              changed.wait(lock,
+                           [&] { return stop || queue.size() < depth; });
+              if (stop) {
+                return;
+              }
+            }
+            S21Matrix a_tile = a.read_tile(ti, tk);
+            S21Matrix b_tile = b.read_tile(tk, tj);
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.emplace_back(std::move(a_tile), std::move(b_tile));
+            changed.notify_all();
+          }
+        }
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      error = std::current_exception();
+      changed.notify_all();
+    }
+  });
+
+  try {
+    for (int ti = 0; ti < tiles_i; ++ti) {
+      for (int tj = 0; tj < tiles_j; ++tj) {
+        S21Matrix c_tile;
+        for (int tk = 0; tk < tiles_k; ++tk) {
+          std::unique_lock<std::mutex> lock(mutex);
+          changed.wait(lock, [&] { return error || !queue.empty(); });
+          if (queue.empty()) {
+            std::rethrow_exception(error);
+          }
+          std::pair<S21Matrix, S21Matrix> pair = std::move(queue.front());
+          queue.pop_front();
+          changed.notify_all();
+          lock.unlock();
+          if (tk == 0) {
+            c_tile = S21Matrix(pair.first.get_rows(), pair.second.get_cols());
+          }
+          S21Matrix::gemm(1.0, pair.first, pair.second, 1.0, c_tile);
+        }
+        c.write_tile(ti, tj, c_tile);
+      }
+    }
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    changed.notify_all();
+    prefetch.join();
+    throw;
+  }
+  prefetch.join();
+}
@@ -0,0 +1,57 @@
+#ifndef S21OUTOFCORE_H
+#define S21OUTOFCORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "s21_matrix_oop.h"
+
+// Матрица в бинарном файле, разбитая на квадратные тайлы tile x tile.
+// Формат: заголовок (магия "S21TILE1", rows, cols, tile как int64),
+// затем тайлы построчно, каждый дополнен нулями до полного размера.
+class S21TiledFile {
+ public:
+  explicit S21TiledFile(const std::string& path);
+  S21TiledFile(const S21TiledFile& other) = delete;
+  S21TiledFile& operator=(const S21TiledFile& other) = delete;
+
+  static S21TiledFile create(const std::string& path, int rows, int cols,
+                             int tile);
+  static void write(const std::string& path, const S21Matrix& matrix,
+                    int tile);
+  static S21Matrix read(const std::string& path);
+  // Наибольший тайл, при котором умножению хватит memory_budget байт.
+  static int tile_for_budget(std::size_t memory_budget);
+
+  int get_rows() const noexcept;
+  int get_cols() const noexcept;
+  int get_tile() const noexcept;
+  int get_tile_rows() const noexcept;
+  int get_tile_cols() const noexcept;
+
+  S21Matrix read_tile(int ti, int tj);
+  void write_tile(int ti, int tj, const S21Matrix& tile);
+
+ private:
+  S21TiledFile(const std::string& path, int rows, int cols, int tile);
+  std::streamoff tile_offset(int ti, int tj) const;
+
+  std::fstream file_;
+  int rows_;
+  int cols_;
+  int tile_;
+};
+
+// Умножение матриц, не помещающихся в память: C = A * B по тайлам.
+// Отдельный поток заранее читает пары тайлов A и B, пока считается
+// текущий тайл C; в памяти одновременно не больше memory_budget байт.
+// Файл C не может совпадать ни с одним из входных.
+class S21OutOfCore {
+ public:
+  static void multiply(const std::string& a_path, const std::string& b_path,
+                       const std::string& c_path, std::size_t memory_budget);
+};
+
+#endif  // S21OUTOFCORE_H
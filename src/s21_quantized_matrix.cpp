@@ -0,0 +1,373 @@
+#include "s21_quantized_matrix.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "s21_thread_pool.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define S21_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace {
+constexpr int kQuantMax = 127;
+constexpr double kParallelOps = 64.0 * 64.0 * 64.0;
+
+std::atomic<int> simd_limit{static_cast<int>(S21SimdLevel::kAvx512)};
+
+using Int8Dot = std::int32_t (*)(const std::int8_t*, const std::int8_t*,
+                                 int);
+using Bf16Dot = float (*)(const std::uint16_t*, const std::uint16_t*, int);
+
+std::int32_t dot_int8_portable(const std::int8_t* a, const std::int8_t* b,
+                               int n) {
+  std::int32_t sum = 0;
+  for (int k = 0; k < n; ++k) {
+    sum += static_cast<std::int32_t>(a[k]) * b[k];
+  }
+  return sum;
+}
+
+float dot_bf16_portable(const std::uint16_t* a, const std::uint16_t* b,
+                        int n) {
+  float sum = 0.0f;
+  for (int k = 0; k < n; ++k) {
+    sum += S21Bf16Matrix::to_float(a[k]) * S21Bf16Matrix::to_float(b[k]);
+  }
+  return sum;
+}
+
+#ifdef S21_X86_KERNELS
+// maddubs умножает беззнаковые байты на знаковые, поэтому знак a
+// переносится на b; -128 при квантовании не возникает, и сумма пары
+// (не больше 2 * 127 * 127) не насыщает int16.
+__attribute__((target("avx2"))) std::int32_t dot_int8_avx2(
+    const std::int8_t* a, const std::int8_t* b, int n) {
+  const __m256i ones = _mm256_set1_epi16(1);
+  __m256i acc = _mm256_setzero_si256();
+  int k = 0;
+  for (; k + 32 <= n; k += 32) {
+    const __m256i va =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k));
+    const __m256i vb =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k));
+    const __m256i pairs = _mm256_maddubs_epi16(_mm256_sign_epi8(va, va),
+                                               _mm256_sign_epi8(vb, va));
+    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(pairs, ones));
+  }
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc),
+                              _mm256_extracti128_si256(acc, 1));
+  sum = _mm_hadd_epi32(sum, sum);
+  sum = _mm_hadd_epi32(sum, sum);
+  return _mm_cvtsi128_si32(sum) + dot_int8_portable(a + k, b + k, n - k);
+}
+
+__attribute__((target("avx512f,avx512bw,avx512vnni"))) std::int32_t
+dot_int8_avx512(const std::int8_t* a, const std::int8_t* b, int n) {
+  const __m512i zero = _mm512_setzero_si512();
+  __m512i acc = zero;
+  int k = 0;
+  for (; k + 64 <= n; k += 64) {
+    const __m512i va = _mm512_loadu_si512(a + k);
+    const __m512i vb = _mm512_loadu_si512(b + k);
+    const __mmask64 negative = _mm512_movepi8_mask(va);
+    const __m512i signed_b = _mm512_mask_sub_epi8(vb, negative, zero, vb);
+    acc = _mm512_dpbusd_epi32(acc, _mm512_abs_epi8(va), signed_b);
+  }
+  // _mm512_reduce_add_* в GCC 12 даёт -Wuninitialized при -O2
+  alignas(64) std::int32_t lanes[16];
+  _mm512_store_si512(lanes, acc);
+  std::int32_t sum = 0;
+  for (std::int32_t lane : lanes) {
+    sum += lane;
+  }
+  return sum + dot_int8_portable(a + k, b + k, n - k);
+}
+
+__attribute__((target("avx2,fma"))) float dot_bf16_avx2(
+    const std::uint16_t* a, const std::uint16_t* b, int n) {
+  __m256 acc = _mm256_setzero_ps();
+  int k = 0;
+  for (; k + 8 <= n; k += 8) {
+    const __m256i wa = _mm256_cvtepu16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + k)));
+    const __m256i wb = _mm256_cvtepu16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + k)));
+    acc = _mm256_fmadd_ps(_mm256_castsi256_ps(_mm256_slli_epi32(wa, 16)),
+                          _mm256_castsi256_ps(_mm256_slli_epi32(wb, 16)),
+                          acc);
+  }
+  __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc),
+                          _mm256_extractf128_ps(acc, 1));
+  sum = _mm_hadd_ps(sum, sum);
+  sum = _mm_hadd_ps(sum, sum);
+  return _mm_cvtss_f32(sum) + dot_bf16_portable(a + k, b + k, n - k);
+}
+
+__attribute__((target("avx512f,avx512bf16"))) float dot_bf16_avx512(
+    const std::uint16_t* a, const std::uint16_t* b, int n) {
+  __m512 acc = _mm512_setzero_ps();
+  int k = 0;
+  for (; k + 32 <= n; k += 32) {
+    const __m512i va = _mm512_loadu_si512(a + k);
+    const __m512i vb = _mm512_loadu_si512(b + k);
+    acc = _mm512_dpbf16_ps(acc, (__m512bh)va, (__m512bh)vb);
+  }
+  alignas(64) float lanes[16];
+  _mm512_store_ps(lanes, acc);
+  float sum = 0.0f;
+  for (float lane : lanes) {
+    sum += lane;
+  }
+  return sum + dot_bf16_portable(a + k, b + k, n - k);
+}
+#endif
+
+Int8Dot select_int8_dot() {
+  const S21SimdLevel level = S21QuantizedMatrix::get_simd_level();
+#ifdef S21_X86_KERNELS
+  if (level == S21SimdLevel::kAvx512) {
+    return dot_int8_avx512;
+  }
+  if (level == S21SimdLevel::kAvx2) {
+    return dot_int8_avx2;
+  }
+#endif
+  (void)level;
+  return dot_int8_portable;
+}
+
+Bf16Dot select_bf16_dot() {
+  const S21SimdLevel level = S21QuantizedMatrix::get_simd_level();
+#ifdef S21_X86_KERNELS
+  if (level == S21SimdLevel::kAvx512 &&
+      __builtin_cpu_supports("avx512bf16")) {
+    return dot_bf16_avx512;
+  }
+  if (level != S21SimdLevel::kPortable && __builtin_cpu_supports("fma")) {
+    return dot_bf16_avx2;
+  }
+#endif
+  (void)level;
+  return dot_bf16_portable;
+}
+
+// c(i, j) = body(i, j) для всех элементов, по строкам параллельно
+template <class F>
+S21Matrix fill_product(int rows, int cols, int length, F body) {
+  S21Matrix result(rows, cols);
+  // row_data() меняет версию матрицы, поэтому в потоках только указатель
+  double* data = result.data();
+  auto rows_block = [&](int lo, int hi) {
+    for (int i = lo; i < hi; ++i) {
+      double* row = data + static_cast<std::size_t>(i) * cols;
+      for (int j = 0; j < cols; ++j) {
+        row[j] = body(i, j);
+      }
+    }
+  };
+  if (static_cast<double>(rows) * cols * length < kParallelOps) {
+    rows_block(0, rows);
+  } else {
+    S21ThreadPool::instance().parallel_for(0, rows, 16, rows_block);
+  }
+  return result;
+}
+
+void check_operands(S21Operand left, S21Operand right, int cols, int rows) {
+  if (left != S21Operand::kLeft || right != S21Operand::kRight) {
+    throw std::invalid_argument(
+        "Quantized product needs a left and a right operand.");
+  }
+  if (cols != rows) {
+    throw std::invalid_argument(
+        "Matrix sizes do not match for multiplication.");
+  }
+}
+}  // namespace
+
+S21QuantizedMatrix::S21QuantizedMatrix(const S21Matrix& matrix,
+                                       S21Operand operand, int group)
+    : rows_(matrix.get_rows()), cols_(matrix.get_cols()), operand_(operand) {
+  if (rows_ < 1 || cols_ < 1) {
+    throw std::length_error("Matrix dimensions cannot be less than one");
+  }
+  if (group < 0) {
+    throw std::invalid_argument("Quantization group cannot be negative.");
+  }
+  const bool left = operand_ == S21Operand::kLeft;
+  const int vectors = left ? rows_ : cols_;
+  length_ = left ? cols_ : rows_;
+  group_ = (group == 0) ? length_ : std::min(group, length_);
+  groups_ = (length_ + group_ - 1) / group_;
+  data_.resize(static_cast<std::size_t>(vectors) * length_);
+  scales_.resize(static_cast<std::size_t>(vectors) * groups_);
+  std::vector<double> values(length_);
+  for (int v = 0; v < vectors; ++v) {
+    for (int p = 0; p < length_; ++p) {
+      values[p] = left ? matrix.at_unchecked(v, p) : matrix.at_unchecked(p, v);
+    }
+    std::int8_t* out = data_.data() + static_cast<std::size_t>(v) * length_;
+    for (int g = 0; g < groups_; ++g) {
+      const int first = g * group_;
+      const int last = std::min(first + group_, length_);
+      double max_abs = 0.0;
+      for (int p = first; p < last; ++p) {
+        max_abs = std::max(max_abs, std::fabs(values[p]));
+      }
+      const float scale = static_cast<float>(max_abs / kQuantMax);
+      scales_[static_cast<std::size_t>(v) * groups_ + g] = scale;
+      for (int p = first; p < last; ++p) {
+        const long q = scale > 0.0f ? std::lround(values[p] / scale) : 0;
+        out[p] = static_cast<std::int8_t>(
+            std::clamp<long>(q, -kQuantMax, kQuantMax));
+      }
+    }
+  }
+}
+
+S21SimdLevel S21QuantizedMatrix::get_simd_level() noexcept {
+  S21SimdLevel detected = S21SimdLevel::kPortable;
+#ifdef S21_X86_KERNELS
+  if (__builtin_cpu_supports("avx512f") &&
+      __builtin_cpu_supports("avx512bw") &&
+      __builtin_cpu_supports("avx512vnni")) {
+    detected = S21SimdLevel::kAvx512;
+  } else if (__builtin_cpu_supports("avx2")) {
+    detected = S21SimdLevel::kAvx2;
+  }
+#endif
+  return static_cast<S21SimdLevel>(
+      std::min(static_cast<int>(detected), simd_limit.load()));
+}
+
+void S21QuantizedMatrix::set_simd_limit(S21SimdLevel limit) noexcept {
+  simd_limit = static_cast<int>(limit);
+}
+
+int S21QuantizedMatrix::get_rows() const noexcept { return rows_; }
+
+int S21QuantizedMatrix::get_cols() const noexcept { return cols_; }
+
+int S21QuantizedMatrix::get_group() const noexcept { return group_; }
+
+S21Operand S21QuantizedMatrix::get_operand() const noexcept {
+  return operand_;
+}
+
+std::size_t S21QuantizedMatrix::get_storage_bytes() const noexcept {
+  return data_.size() * sizeof(std::int8_t) + scales_.size() * sizeof(float);
+}
+
+S21Matrix S21QuantizedMatrix::to_matrix() const {
+  S21Matrix result(rows_, cols_);
+  const bool left = operand_ == S21Operand::kLeft;
+  const int vectors = left ? rows_ : cols_;
+  for (int v = 0; v < vectors; ++v) {
+    const std::int8_t* q = vector_ptr(v);
+    for (int p = 0; p < length_; ++p) {
+      const double value =
+          scales_[static_cast<std::size_t>(v) * groups_ + p / group_] * q[p];
+      (left ? result.at_unchecked(v, p) : result.at_unchecked(p, v)) = value;
+    }
+  }
+  return result;
+}
+
+S21Matrix S21QuantizedMatrix::mul_matrix(
+    const S21QuantizedMatrix& other) const {
+  check_operands(operand_, other.operand_, cols_, other.rows_);
+  if (group_ != other.group_) {
+    throw std::invalid_argument("Quantization groups do not match.");
+  }
+  const Int8Dot dot = select_int8_dot();
+  return fill_product(rows_, other.cols_, length_, [&](int i, int j) {
+    const std::int8_t* a = vector_ptr(i);
+    const std::int8_t* b = other.vector_ptr(j);
+    const float* scale_a = scales_.data() + static_cast<std::size_t>(i) *
+                                                groups_;
+    const float* scale_b = other.scales_.data() +
+                           static_cast<std::size_t>(j) * groups_;
+    double sum = 0.0;
+    for (int g = 0; g < groups_; ++g) {
+      const int first = g * group_;
+      const int count = std::min(group_, length_ - first);
+      sum += static_cast<double>(scale_a[g]) * scale_b[g] *
+             dot(a + first, b + first, count);
+    }
+    return sum;
+  });
+}
+
+S21Bf16Matrix::S21Bf16Matrix(const S21Matrix& matrix, S21Operand operand)
+    : rows_(matrix.get_rows()), cols_(matrix.get_cols()), operand_(operand) {
+  if (rows_ < 1 || cols_ < 1) {
+    throw std::length_error("Matrix dimensions cannot be less than one");
+  }
+  const bool left = operand_ == S21Operand::kLeft;
+  const int vectors = left ? rows_ : cols_;
+  length_ = left ? cols_ : rows_;
+  data_.resize(static_cast<std::size_t>(vectors) * length_);
+  for (int v = 0; v < vectors; ++v) {
+    std::uint16_t* out = data_.data() + static_cast<std::size_t>(v) * length_;
+    for (int p = 0; p < length_; ++p) {
+      out[p] = from_float(static_cast<float>(
+          left ? matrix.at_unchecked(v, p) : matrix.at_unchecked(p, v)));
+    }
+  }
+}
+
+std::uint16_t S21Bf16Matrix::from_float(float value) noexcept {
+  std::uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  if (std::isnan(value)) {
+    return static_cast<std::uint16_t>((bits >> 16) | 0x40);
+  }
+  // округление к ближайшему чётному
+  bits += 0x7FFF + ((bits >> 16) & 1);
+  return static_cast<std::uint16_t>(bits >> 16);
+}
+
+float S21Bf16Matrix::to_float(std::uint16_t value) noexcept {
+  const std::uint32_t bits = static_cast<std::uint32_t>(value) << 16;
+  float result;
+  std::memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+int S21Bf16Matrix::get_rows() const noexcept { return rows_; }
+
+int S21Bf16Matrix::get_cols() const noexcept { return cols_; }
+
+S21Operand S21Bf16Matrix::get_operand() const noexcept { return operand_; }
+
+std::size_t S21Bf16Matrix::get_storage_bytes() const noexcept {
+  return data_.size() * sizeof(std::uint16_t);
+}
+
+S21Matrix S21Bf16Matrix::to_matrix() const {
+  S21Matrix result(rows_, cols_);
+  const bool left = operand_ == S21Operand::kLeft;
+  const int vectors = left ? rows_ : cols_;
+  for (int v = 0; v < vectors; ++v) {
+    const std::uint16_t* values = vector_ptr(v);
+    for (int p = 0; p < length_; ++p) {
+      (left ? result.at_unchecked(v, p) : result.at_unchecked(p, v)) =
+          to_float(values[p]);
+    }
+  }
+  return result;
+}
+
+S21Matrix S21Bf16Matrix::mul_matrix(const S21Bf16Matrix& other) const {
+  check_operands(operand_, other.operand_, cols_, other.rows_);
+  const Bf16Dot dot = select_bf16_dot();
+  return fill_product(rows_, other.cols_, length_, [&](int i, int j) {
+    return static_cast<double>(
+        dot(vector_ptr(i), other.vector_ptr(j), length_));
+  });
+}
@@ -0,0 +1,88 @@
+#ifndef S21QUANTIZEDMATRIX_H
+#define S21QUANTIZEDMATRIX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Роль операнда в произведении A * B: у левого построчно хранятся
+// строки, у правого - столбцы, чтобы свёртка шла по непрерывной памяти.
+enum class S21Operand { kLeft, kRight };
+
+// Набор инструкций для ядер; kAvx512 означает AVX-512 VNNI для int8
+// и AVX-512 BF16 для bf16.
+enum class S21SimdLevel { kPortable, kAvx2, kAvx512 };
+
+// Симметричное квантование в int8: x ~ scale * q, q в [-127, 127].
+// Масштаб общий для группы из group подряд идущих элементов вектора
+// свёртки (group = 0 - один масштаб на строку или столбец).
+class S21QuantizedMatrix {
+ public:
+  explicit S21QuantizedMatrix(const S21Matrix& matrix,
+                              S21Operand operand = S21Operand::kLeft,
+                              int group = 0);
+
+  // самый широкий доступный набор инструкций не выше предела
+  static S21SimdLevel get_simd_level() noexcept;
+  static void set_simd_limit(S21SimdLevel limit) noexcept;
+
+  int get_rows() const noexcept;
+  int get_cols() const noexcept;
+  int get_group() const noexcept;
+  S21Operand get_operand() const noexcept;
+  std::size_t get_storage_bytes() const noexcept;
+
+  // деквантование
+  S21Matrix to_matrix() const;
+  // int8 x int8 -> int32 внутри группы, затем умножение на масштабы;
+  // this - левый операнд, other - правый с той же группой
+  S21Matrix mul_matrix(const S21QuantizedMatrix& other) const;
+
+ private:
+  const std::int8_t* vector_ptr(int v) const noexcept {
+    return data_.data() + static_cast<std::size_t>(v) * length_;
+  }
+
+  int rows_;
+  int cols_;
+  S21Operand operand_;
+  int length_;
+  int group_;
+  int groups_;
+  std::vector<std::int8_t> data_;
+  std::vector<float> scales_;
+};
+
+// Матрица в формате bfloat16 (старшие 16 бит float); свёртка
+// накапливается во float.
+class S21Bf16Matrix {
+ public:
+  explicit S21Bf16Matrix(const S21Matrix& matrix,
+                         S21Operand operand = S21Operand::kLeft);
+
+  static std::uint16_t from_float(float value) noexcept;
+  static float to_float(std::uint16_t value) noexcept;
+
+  int get_rows() const noexcept;
+  int get_cols() const noexcept;
+  S21Operand get_operand() const noexcept;
+  std::size_t get_storage_bytes() const noexcept;
+
+  S21Matrix to_matrix() const;
+  S21Matrix mul_matrix(const S21Bf16Matrix& other) const;
+
+ private:
+  const std::uint16_t* vector_ptr(int v) const noexcept {
+    return data_.data() + static_cast<std::size_t>(v) * length_;
+  }
+
+  int rows_;
+  int cols_;
+  S21Operand operand_;
+  int length_;
+  std::vector<std::uint16_t> data_;
+};
+
+#endif  // S21QUANTIZEDMATRIX_H
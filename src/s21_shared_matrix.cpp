@@ -0,0 +1,250 @@
+// Барьеры seqlock нужны для корректности; TSan их не моделирует.
+#if defined(__SANITIZE_THREAD__)
+#pragma GCC diagnostic ignored "-Wtsan"
+#endif
+
+#include "s21_shared_matrix.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#include "s21_thread_pool.h"
+#include "s21_tuning.h"
+
+namespace {
+const char kMagic[8] = {'S', '2', '1', 'S', 'H', 'M', '0', '1'};
+
+std::runtime_error system_error(const std::string& what,
+                                const std::string& name) {
+  return std::runtime_error(what + " " + name + ": " + std::strerror(errno));
+}
+}  // namespace
+
+struct S21SharedMatrix::Header {
+  char magic[8];
+  std::int64_t rows;
+  std::int64_t cols;
+  std::atomic<std::uint64_t> sequence;
+  // данные начинаются с границы кэш-линии
+  char padding[64 - 8 - 3 * 8];
+};
+
+static_assert(sizeof(std::atomic<std::uint64_t>) == 8,
+              "Sequence counter must be 8 bytes");
+
+S21SharedMatrix::S21SharedMatrix(void* mapping, std::size_t length,
+                                 bool read_only)
+    : mapping_(mapping), length_(length), read_only_(read_only) {}
+
+S21SharedMatrix::S21SharedMatrix(S21SharedMatrix&& other) noexcept
+    : mapping_(other.mapping_),
+      length_(other.length_),
+      read_only_(other.read_only_) {
+  other.mapping_ = nullptr;
+  other.length_ = 0;
+}
+
+S21SharedMatrix::~S21SharedMatrix() {
+  if (mapping_ != nullptr) {
+    munmap(mapping_, length_);
+  }
+}
+
+S21SharedMatrix S21SharedMatrix::create(const std::string& name, int rows,
+                                        int cols) {
+  if (rows < 1 || cols < 1) {
+    throw std::length_error("Matrix dimensions cannot be less than one");
+  }
+  const std::size_t length =
+      sizeof(Header) + static_cast<std::size_t>(rows) * cols * sizeof(double);
+  // O_EXCL: чужой сегмент с подключёнными читателями не обрезается
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0 && errno == EEXIST) {
+    throw std::runtime_error("Shared matrix " + name + " already exists");
+  }
+  if (fd < 0) {
+    throw system_error("Cannot create shared matrix", name);
+  }
+  void* mapping = MAP_FAILED;
+  if (ftruncate(fd, static_cast<off_t>(length)) == 0) {
+    mapping =
+        mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  const int error = errno;
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    errno = error;
+    throw system_error("Cannot map shared matrix", name);
+  }
+  Header* header = new (mapping) Header();
+  header->rows = rows;
+  header->cols = cols;
+  header->sequence.store(0, std::memory_order_relaxed);
+  // магия пишется последней: по ней читатели узнают готовый сегмент
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(header->magic, kMagic, sizeof(kMagic));
+  return S21SharedMatrix(mapping, length, false);
+}
+
+S21SharedMatrix S21SharedMatrix::attach(const std::string& name,
+                                        bool read_only) {
+  int fd = shm_open(name.c_str(), read_only ? O_RDONLY : O_RDWR, 0);
+  if (fd < 0) {
+    throw system_error("Cannot open shared matrix", name);
+  }
+  struct stat info;
+  void* mapping = MAP_FAILED;
+  std::size_t length = 0;
+  if (fstat(fd, &info) == 0 &&
+      static_cast<std::size_t>(info.st_size) >= sizeof(Header)) {
+    length = static_cast<std::size_t>(info.st_size);
+    mapping = mmap(nullptr, length,
+                   read_only ? PROT_READ : PROT_READ | PROT_WRITE,
+                   MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    throw std::runtime_error("Cannot map shared matrix " + name);
+  }
+  S21SharedMatrix result(mapping, length, read_only);
+  const Header* header = result.header();
+  if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 ||
+      header->rows < 1 || header->cols < 1 ||
+      length < sizeof(Header) + static_cast<std::size_t>(header->rows) *
+                                    header->cols * sizeof(double)) {
+    throw std::runtime_error("Invalid shared matrix segment " + name);
+  }
+  return result;
+}
+
+void S21SharedMatrix::unlink(const std::string& name) {
+  if (shm_unlink(name.c_str()) != 0) {
+    throw system_error("Cannot unlink shared matrix", name);
+  }
+}
+
+S21SharedMatrix::Header* S21SharedMatrix::header() const noexcept {
+  return static_cast<Header*>(mapping_);
+}
+
+int S21SharedMatrix::get_rows() const noexcept {
+  return static_cast<int>(header()->rows);
+}
+
+int S21SharedMatrix::get_cols() const noexcept {
+  return static_cast<int>(header()->cols);
+}
+
+bool S21SharedMatrix::is_read_only() const noexcept { return read_only_; }
+
+unsigned long long S21SharedMatrix::get_version() const noexcept {
+  return header()->sequence.load(std::memory_order_acquire) / 2;
+}
+
+const double* S21SharedMatrix::data() const noexcept {
+  return reinterpret_cast<const double*>(static_cast<char*>(mapping_) +
+                                         sizeof(Header));
+}
+
+double S21SharedMatrix::operator()(int i, int j) const {
+  if (i < 0 || i >= get_rows() || j < 0 || j >= get_cols()) {
+    throw std::out_of_range("Index out of bounds");
+  }
+  return data()[static_cast<std::size_t>(i) * get_cols() + j];
+}
+
+void S21SharedMatrix::publish(const S21Matrix& matrix) {
+  if (read_only_) {
+    throw std::logic_error("Shared matrix is attached read-only.");
+  }
+  if (matrix.get_rows() != get_rows() || matrix.get_cols() != get_cols()) {
+    throw std::invalid_argument("Matrix sizes do not match for publishing.");
+  }
+  std::atomic<std::uint64_t>& sequence = header()->sequence;
+  const std::uint64_t start = sequence.load(std::memory_order_relaxed);
+  sequence.store(start + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(const_cast<double*>(data()), matrix.data(),
+              static_cast<std::size_t>(get_rows()) * get_cols() *
+                  sizeof(double));
+  sequence.store(start + 2, std::memory_order_release);
+}
+
+S21Matrix S21SharedMatrix::snapshot() const {
+  S21Matrix result(get_rows(), get_cols());
+  const std::size_t bytes =
+      static_cast<std::size_t>(get_rows()) * get_cols() * sizeof(double);
+  const std::atomic<std::uint64_t>& sequence = header()->sequence;
+  while (true) {
+    const std::uint64_t before = sequence.load(std::memory_order_acquire);
+    if (before % 2 == 0) {
+      std::memcpy(result.data(), data(), bytes);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sequence.load(std::memory_order_relaxed) == before) {
+        break;
+      }
+    }
+    std::this_thread::yield();
+  }
+  return result;
+}
+
+S21Matrix S21SharedMatrix::mul_matrix(const S21Matrix& other) const {
+  const int rows = get_rows();
+  const int inner = get_cols();
+  const int cols = other.get_cols();
+  if (other.get_rows() != inner) {
+    throw std::invalid_argument(
+        "Matrix sizes do not match for multiplication.");
+  }
+  S21Matrix result(rows, cols);
+  // указатель берётся один раз: data() меняет версию матрицы
+  double* out = result.data();
+  const double* values = data();
+  auto rows_block = [out, values, &other, inner, cols](int lo, int hi) {
+    for (int i = lo; i < hi; ++i) {
+      double* c_row = out + static_cast<std::size_t>(i) * cols;
+      const double* a_row = values + static_cast<std::size_t>(i) * inner;
+      std::fill_n(c_row, cols, 0.0);
+      for (int k = 0; k < inner; ++k) {
+        const double a_ik = a_row[k];
+        const double* b_row = other.row_data(k);
+        for (int j = 0; j < cols; ++j) {
+          c_row[j] += a_ik * b_row[j];
+        }
+      }
+    }
+  };
+  const S21TuningProfile tuning = S21Tuning::get();
+  const double flops = static_cast<double>(rows) * inner * cols;
+  const std::atomic<std::uint64_t>& sequence = header()->sequence;
+  while (true) {
+    const std::uint64_t before = sequence.load(std::memory_order_acquire);
+    if (before % 2 == 0) {
+      if (flops < tuning.gemm_parallel_flops) {
+        rows_block(0, rows);
+      } else {
+        S21ThreadPool::instance().parallel_for(0, rows, tuning.gemm_grain,
+                                               rows_block);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sequence.load(std::memory_order_relaxed) == before) {
+        break;
+      }
+    }
+    std::this_thread::yield();
+  }
+  return result;
+}
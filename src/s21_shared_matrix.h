@@ -0,0 +1,58 @@
+#ifndef S21SHAREDMATRIX_H
+#define S21SHAREDMATRIX_H
+
+#include <cstddef>
+#include <string>
+
+#include "s21_matrix_oop.h"
+
+// Матрица в именованном сегменте POSIX shared memory. Один процесс
+// создаёт сегмент и публикует данные, остальные подключаются к нему
+// только для чтения без копирования. Заголовок хранит размеры и номер
+// версии: нечётное значение означает, что идёт запись (seqlock).
+// Без копирования работают data(), operator() и mul_matrix; остальные
+// операции S21Matrix доступны только через snapshot(), то есть на
+// собственной копии процесса.
+class S21SharedMatrix {
+ public:
+  // Бросает исключение, если сегмент с таким именем уже есть.
+  static S21SharedMatrix create(const std::string& name, int rows, int cols);
+  static S21SharedMatrix attach(const std::string& name,
+                                bool read_only = true);
+  static void unlink(const std::string& name);
+
+  S21SharedMatrix(const S21SharedMatrix& other) = delete;
+  S21SharedMatrix(S21SharedMatrix&& other) noexcept;
+  S21SharedMatrix& operator=(const S21SharedMatrix& other) = delete;
+  ~S21SharedMatrix();
+
+  int get_rows() const noexcept;
+  int get_cols() const noexcept;
+  bool is_read_only() const noexcept;
+  // число завершённых публикаций
+  unsigned long long get_version() const noexcept;
+
+  // Прямой доступ к разделяемым данным без копирования.
+  const double* data() const noexcept;
+  double operator()(int i, int j) const;
+
+  // this * other прямо по разделяемым данным; при наложении на
+  // публикацию произведение пересчитывается.
+  S21Matrix mul_matrix(const S21Matrix& other) const;
+
+  void publish(const S21Matrix& matrix);
+  // Согласованная копия: чтение повторяется, если попало на запись.
+  S21Matrix snapshot() const;
+
+ private:
+  struct Header;
+
+  S21SharedMatrix(void* mapping, std::size_t length, bool read_only);
+  Header* header() const noexcept;
+
+  void* mapping_;
+  std::size_t length_;
+  bool read_only_;
+};
+
+#endif  // S21SHAREDMATRIX_H
@@ -0,0 +1,581 @@
+#include "s21_structured_matrix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+void check_size(int size) {
+  if (size < 1) {
+    throw std::length_error("Matrix dimensions cannot be less than one");
+  }
+}
+
+void check_square(const S21Matrix& matrix) {
+  if (matrix.get_rows() != matrix.get_cols()) {
+    throw std::invalid_argument("Structured matrix must be square.");
+  }
+}
+
+// порог, ниже которого ведущий элемент считается нулевым
+double singular_threshold(int size, double norm) {
+  return size * norm * std::numeric_limits<double>::epsilon();
+}
+}  // namespace
+
+S21SymmetricMatrix::S21SymmetricMatrix(int size) : size_(size) {
+  check_size(size_);
+  data_.assign(static_cast<std::size_t>(size_) * (size_ + 1) / 2, 0.0);
+}
+
+S21SymmetricMatrix::S21SymmetricMatrix(const S21Matrix& matrix)
+    : S21SymmetricMatrix(matrix.get_rows()) {
+  check_square(matrix);
+  for (int i = 0; i < size_; ++i) {
+    const double* row = matrix.row_data(i);
+    std::copy(row + i, row + size_, data_.begin() + index(i, i));
+  }
+}
+
+S21SymmetricMatrix S21SymmetricMatrix::syrk(const S21Matrix& a) {
+  S21SymmetricMatrix result(a.get_rows());
+  result.rank_k_update(a);
+  return result;
+}
+
+int S21SymmetricMatrix::get_size() const noexcept { return size_; }
+
+std::size_t S21SymmetricMatrix::get_storage_size() const noexcept {
+  return data_.size();
+}
+
+std::size_t S21SymmetricMatrix::index(int i, int j) const noexcept {
+  if (i > j) {
+    std::swap(i, j);
+  }
+  // перед строкой i лежат строки длины n, n - 1, ..., n - i + 1
+  return static_cast<std::size_t>(i) * size_ -
+         static_cast<std::size_t>(i) * (i - 1) / 2 + (j - i);
+}
+
+S21Matrix S21SymmetricMatrix::to_matrix() const {
+  S21Matrix result(size_, size_);
+  for (int i = 0; i < size_; ++i) {
+    const double* packed = data_.data() + index(i, i);
+    for (int j = i; j < size_; ++j) {
+      result.at_unchecked(i, j) = packed[j - i];
+      result.at_unchecked(j, i) = packed[j - i];
+    }
+  }
+  return result;
+}
+
+S21Matrix S21SymmetricMatrix::mul_matrix(const S21Matrix& other) const {
+  if (other.get_rows() != size_) {
+    throw std::invalid_argument(
+        "Matrix sizes do not match for multiplication.");
+  }
+  const int cols = other.get_cols();
+  S21Matrix result(size_, cols);
+  // каждый внедиагональный элемент вносит вклад в две строки
+  for (int i = 0; i < size_; ++i) {
+    const double* packed = data_.data() + index(i, i);
+    const double* b_i = other.row_data(i);
+    double* c_i = result.row_data(i);
+    for (int k = 0; k < cols; ++k) {
+      c_i[k] += packed[0] * b_i[k];
+    }
+    for (int j = i + 1; j < size_; ++j) {
+      const double value = packed[j - i];
+      const double* b_j = other.row_data(j);
+      double* c_j = result.row_data(j);
+      for (int k = 0; k < cols; ++k) {
+        c_i[k] += value * b_j[k];
+        c_j[k] += value * b_i[k];
+      }
+    }
+  }
+  return result;
+}
+
+void S21SymmetricMatrix::rank_k_update(const S21Matrix& a, double alpha) {
+  if (a.get_rows() != size_) {
+    throw std::invalid_argument("Matrix sizes do not match for update.");
+  }
+  const int k = a.get_cols();
+  for (int i = 0; i < size_; ++i) {
+    const double* a_i = a.row_data(i);
+    double* packed = data_.data() + index(i, i);
+    for (int j = i; j < size_; ++j) {
+      const double* a_j = a.row_data(j);
+      double dot = 0.0;
+      for (int p = 0; p < k; ++p) {
+        dot += a_i[p] * a_j[p];
+      }
+      packed[j - i] += alpha * dot;
+    }
+  }
+}
+
+// LDL^T в упакованном виде с выбором ведущих блоков по Банчу-Кауфману:
+// D состоит из блоков 1x1 и 2x2, det = prod(det D_k), симметричные
+// перестановки определитель не меняют.
+double S21SymmetricMatrix::determinant() const {
+  std::vector<double> w(data_);
+  auto at = [this, &w](int i, int j) -> double& { return w[index(i, j)]; };
+  double norm = 0.0;
+  for (int i = 0; i < size_; ++i) {
+    double row_sum = 0.0;
+    for (int j = 0; j < size_; ++j) {
+      row_sum += std::fabs(at(i, j));
+    }
+    norm = std::max(norm, row_sum);
+  }
+  const double eps = singular_threshold(size_, norm);
+  const double alpha = (1.0 + std::sqrt(17.0)) / 8.0;
+  double det = 1.0;
+  int k = 0;
+  while (k < size_) {
+    const double diagonal = std::fabs(at(k, k));
+    int r = k;
+    double col_max = 0.0;
+    for (int i = k + 1; i < size_; ++i) {
+      if (std::fabs(at(i, k)) > col_max) {
+        col_max = std::fabs(at(i, k));
+        r = i;
+      }
+    }
+    if (std::max(diagonal, col_max) <= eps) {
+      return 0.0;
+    }
+    int step = 1;
+    int pivot = k;
+    if (diagonal < alpha * col_max) {
+      double row_max = 0.0;
+      for (int j = k; j < size_; ++j) {
+        if (j != r) {
+          row_max = std::max(row_max, std::fabs(at(r, j)));
+        }
+      }
+      if (diagonal * row_max < alpha * col_max * col_max) {
+        pivot = r;
+        step = std::fabs(at(r, r)) >= alpha * row_max ? 1 : 2;
+      }
+    }
+    // ведущая строка переезжает на место k (или k + 1 для блока 2x2)
+    const int target = k + step - 1;
+    if (pivot != target) {
+      std::swap(at(target, target), at(pivot, pivot));
+      for (int j = k; j < size_; ++j) {
+        if (j != target && j != pivot) {
+          std::swap(at(target, j), at(pivot, j));
+        }
+      }
+    }
+    if (step == 1) {
+      const double d = at(k, k);
+      det *= d;
+      for (int i = k + 1; i < size_; ++i) {
+        const double l_i = at(i, k) / d;
+        for (int j = i; j < size_; ++j) {
+          at(i, j) -= l_i * at(j, k);
+        }
+      }
+    } else {
+      const double a = at(k, k);
+      const double b = at(k, k + 1);
+      const double c = at(k + 1, k + 1);
+      const double d = a * c - b * b;
+      det *= d;
+      // A22 -= [x y] * D^-1 * [x y]^T, D^-1 = [c -b; -b a] / d
+      for (int i = k + 2; i < size_; ++i) {
+        const double x_i = at(i, k);
+        const double y_i = at(i, k + 1);
+        const double u_i = (c * x_i - b * y_i) / d;
+        const double v_i = (a * y_i - b * x_i) / d;
+        for (int j = i; j < size_; ++j) {
+          at(i, j) -= u_i * at(j, k) + v_i * at(j, k + 1);
+        }
+      }
+    }
+    k += step;
+  }
+  return det;
+}
+
+double& S21SymmetricMatrix::operator()(int i, int j) {
+  if (i < 0 || i >= size_ || j < 0 || j >= size_) {
+    throw std::out_of_range("Index out of bounds");
+  }
+  return data_[index(i, j)];
+}
+
+const double& S21SymmetricMatrix::operator()(int i, int j) const {
+  if (i < 0 || i >= size_ || j < 0 || j >= size_) {
+    throw std::out_of_range("Index out of bounds");
+  }
+  return data_[index(i, j)];
+}
+
+S21TriangularMatrix::S21TriangularMatrix(int size, bool upper)
+    : size_(size), upper_(upper) {
+  check_size(size_);
+  data_.assign(static_cast<std::size_t>(size_) * (size_ + 1) / 2, 0.0);
+}
+
+S21TriangularMatrix::S21TriangularMatrix(const S21Matrix& matrix, bool upper)
+    : S21TriangularMatrix(matrix.get_rows(), upper) {
+  check_square(matrix);
+  for (int i = 0; i < size_; ++i) {
+    const double* row = matrix.row_data(i);
+    if (upper_) {
+      std::copy(row + i, row + size_, data_.begin() + index(i, i));
+    } else {
+      std::copy(row, row + i + 1, data_.begin() + index(i, 0));
+    }
+  }
+}
+
+int S21TriangularMatrix::get_size() const noexcept { return size_; }
+
+bool S21TriangularMatrix::is_upper() const noexcept { return upper_; }
+
+std::size_t S21TriangularMatrix::get_storage_size() const noexcept {
+  return data_.size();
+}
+
+bool S21TriangularMatrix::in_structure(int i, int j) const noexcept {
+  return upper_ ? i <= j : j <= i;
+}
+
+std::size_t S21TriangularMatrix::index(int i, int j) const noexcept {
+  if (upper_) {
+    return static_cast<std::size_t>(i) * size_ -
+           static_cast<std::size_t>(i) * (i - 1) / 2 + (j - i);
+  }
+  return static_cast<std::size_t>(i) * (i + 1) / 2 + j;
+}
+
+S21Matrix S21TriangularMatrix::to_matrix() const {
+  S21Matrix result(size_, size_);
+  for (int i = 0; i < size_; ++i) {
+    const int first = upper_ ? i : 0;
+    const int last = upper_ ? size_ : i + 1;
+    std::copy(data_.begin() + index(i, first),
+              data_.begin() + index(i, first) + (last - first),
+              result.row_data(i) + first);
+  }
+  return result;
+}
+
+S21TriangularMatrix S21TriangularMatrix::transpose() const {
+  S21TriangularMatrix result(size_, !upper_);
+  for (int i = 0; i < size_; ++i) {
+    const int first = upper_ ? i : 0;
+    const int last = upper_ ? size_ : i + 1;
+    for (int j = first; j < last; ++j) {
+      result.data_[result.index(j, i)] = data_[index(i, j)];
+    }
+  }
+  return result;
+}
+
+S21Matrix S21TriangularMatrix::mul_matrix(const S21Matrix& other) const {
+  if (other.get_rows() != size_) {
+    throw std::invalid_argument(
+        "Matrix sizes do not match for multiplication.");
+  }
+  const int cols = other.get_cols();
+  S21Matrix result(size_, cols);
+  for (int i = 0; i < size_; ++i) {
+    const int first = upper_ ? i : 0;
+    const int last = upper_ ? size_ : i + 1;
+    const double* packed = data_.data() + index(i, first);
+    double* c_i = result.row_data(i);
+    for (int j = first; j < last; ++j) {
+      const double value = packed[j - first];
+      const double* b_j = other.row_data(j);
+      for (int k = 0; k < cols; ++k) {
+        c_i[k] += value * b_j[k];
+      }
+    }
+  }
+  return result;
+}
+
+double S21TriangularMatrix::determinant() const noexcept {
+  double det = 1.0;
+  for (int i = 0; i < size_; ++i) {
+    det *= data_[index(i, i)];
+  }
+  return det;
+}
+
+S21Matrix S21TriangularMatrix::solve(const S21Matrix& b) const {
+  if (b.get_rows() != size_) {
+    throw std::invalid_argument("Matrix sizes do not match for solving.");
+  }
+  double norm = 0.0;
+  for (int i = 0; i < size_; ++i) {
+    const int first = upper_ ? i : 0;
+    const int last = upper_ ? size_ : i + 1;
+    double row_sum = 0.0;
+    for (int j = first; j < last; ++j) {
+      row_sum += std::fabs(data_[index(i, j)]);
+    }
+    norm = std::max(norm, row_sum);
+  }
+  const double eps = singular_threshold(size_, norm);
+  for (int i = 0; i < size_; ++i) {
+    if (std::fabs(data_[index(i, i)]) <= eps) {
+      throw std::invalid_argument("Cannot solve a system with determinant 0.");
+    }
+  }
+  const int cols = b.get_cols();
+  S21Matrix x(b);
+  // строки обрабатываются целиком, чтобы обход шёл по памяти подряд
+  for (int step = 0; step < size_; ++step) {
+    const int i = upper_ ? size_ - 1 - step : step;
+    const int first = upper_ ? i + 1 : 0;
+    const int last = upper_ ? size_ : i;
+    double* x_i = x.row_data(i);
+    for (int j = first; j < last; ++j) {
+      const double value = data_[index(i, j)];
+      const double* x_j = x.row_data(j);
+      for (int k = 0; k < cols; ++k) {
+        x_i[k] -= value * x_j[k];
+      }
+    }
+    const double diagonal = data_[index(i, i)];
+    for (int k = 0; k < cols; ++k) {
+      x_i[k] /= diagonal;
+    }
+  }
+  return x;
+}
+
+double& S21TriangularMatrix::operator()(int i, int j) {
+  if (i < 0 || i >= size_ || j < 0 || j >= size_) {
+    throw std::out_of_range("Index out of bounds");
+  }
+  if (!in_structure(i, j)) {
+    throw std::out_of_range("Element is outside the triangle");
+  }
+  return data_[index(i, j)];
+}
+
+double S21TriangularMatrix::operator()(int i, int j) const {
+  if (i < 0 || i >= size_ || j < 0 || j >= size_) {
+    throw std::out_of_range("Index out of bounds");
+  }
+  return in_structure(i, j) ? data_[index(i, j)] : 0.0;
+}
+
+S21BandedMatrix::S21BandedMatrix(int size, int lower, int upper)
+    : size_(size), lower_(lower), upper_(upper) {
+  check_size(size_);
+  if (lower_ < 0 || upper_ < 0) {
+    throw std::length_error("Bandwidth cannot be negative");
+  }
+  lower_ = std::min(lower_, size_ - 1);
+  upper_ = std::min(upper_, size_ - 1);
+  data_.assign(static_cast<std::size_t>(size_) * (lower_ + upper_ + 1), 0.0);
+}
+
+S21BandedMatrix::S21BandedMatrix(const S21Matrix& matrix, int lower,
+                                 int upper)
+    : S21BandedMatrix(matrix.get_rows(), lower, upper) {
+  check_square(matrix);
+  const int width = lower_ + upper_ + 1;
+  for (int i = 0; i < size_; ++i) {
+    const int first = std::max(0, i - lower_);
+    const int last = std::min(size_, i + upper_ + 1);
+    const double* row = matrix.row_data(i);
+    std::copy(row + first, row + last,
+              data_.begin() + static_cast<std::size_t>(i) * width +
+                  (first - i + lower_));
+  }
+}
+
+int S21BandedMatrix::get_size() const noexcept { return size_; }
+
+int S21BandedMatrix::get_lower() const noexcept { return lower_; }
+
+int S21BandedMatrix::get_upper() const noexcept { return upper_; }
+
+std::size_t S21BandedMatrix::get_storage_size() const noexcept {
+  return data_.size();
+}
+
+bool S21BandedMatrix::in_structure(int i, int j) const noexcept {
+  return j >= i - lower_ && j <= i + upper_;
+}
+
+S21Matrix S21BandedMatrix::to_matrix() const {
+  S21Matrix result(size_, size_);
+  const int width = lower_ + upper_ + 1;
+  for (int i = 0; i < size_; ++i) {
+    const int first = std::max(0, i - lower_);
+    const int last = std::min(size_, i + upper_ + 1);
+    const double* band =
+        data_.data() + static_cast<std::size_t>(i) * width - i + lower_;
+    std::copy(band + first, band + last, result.row_data(i) + first);
+  }
+  return result;
+}
+
+S21Matrix S21BandedMatrix::mul_matrix(const S21Matrix& other) const {
+  if (other.get_rows() != size_) {
+    throw std::invalid_argument(
+        "Matrix sizes do not match for multiplication.");
+  }
+  const int cols = other.get_cols();
+  const int width = lower_ + upper_ + 1;
+  S21Matrix result(size_, cols);
+  for (int i = 0; i < size_; ++i) {
+    const int first = std::max(0, i - lower_);
+    const int last = std::min(size_, i + upper_ + 1);
+    const double* band =
+        data_.data() + static_cast<std::size_t>(i) * width - i + lower_;
+    double* c_i = result.row_data(i);
+    for (int j = first; j < last; ++j) {
+      const double value = band[j];
+      const double* b_j = other.row_data(j);
+      for (int k = 0; k < cols; ++k) {
+        c_i[k] += value * b_j[k];
+      }
+    }
+  }
+  return result;
+}
+
+S21BandedMatrix::Factorization S21BandedMatrix::factorize() const {
+  const int width = 2 * lower_ + upper_ + 1;
+  Factorization result;
+  result.lu.assign(static_cast<std::size_t>(size_) * width, 0.0);
+  result.pivots.resize(size_);
+  auto at = [&result, width, this](int i, int j) -> double& {
+    return result.lu[static_cast<std::size_t>(i) * width + (j - i + lower_)];
+  };
+  double norm = 0.0;
+  for (int i = 0; i < size_; ++i) {
+    double row_sum = 0.0;
+    for (int j = std::max(0, i - lower_); j <= std::min(size_ - 1, i + upper_);
+         ++j) {
+      at(i, j) = (*this)(i, j);
+      row_sum += std::fabs(at(i, j));
+    }
+    norm = std::max(norm, row_sum);
+  }
+  const double eps = singular_threshold(size_, norm);
+  for (int k = 0; k < size_; ++k) {
+    const int last_row = std::min(size_ - 1, k + lower_);
+    const int last_col = std::min(size_ - 1, k + lower_ + upper_);
+    int pivot = k;
+    for (int i = k + 1; i <= last_row; ++i) {
+      if (std::fabs(at(i, k)) > std::fabs(at(pivot, k))) {
+        pivot = i;
+      }
+    }
+    result.pivots[k] = pivot;
+    if (pivot != k) {
+      for (int j = k; j <= last_col; ++j) {
+        std::swap(at(k, j), at(pivot, j));
+      }
+      result.sign = -result.sign;
+    }
+    if (std::fabs(at(k, k)) <= eps) {
+      result.singular = true;
+      continue;
+    }
+    for (int i = k + 1; i <= last_row; ++i) {
+      const double factor = at(i, k) / at(k, k);
+      at(i, k) = factor;
+      for (int j = k + 1; j <= last_col; ++j) {
+        at(i, j) -= factor * at(k, j);
+      }
+    }
+  }
+  return result;
+}
+
+double S21BandedMatrix::determinant() const {
+  const Factorization lu = factorize();
+  if (lu.singular) {
+    return 0.0;
+  }
+  const int width = 2 * lower_ + upper_ + 1;
+  double det = lu.sign;
+  for (int i = 0; i < size_; ++i) {
+    det *= lu.lu[static_cast<std::size_t>(i) * width + lower_];
+  }
+  return det;
+}
+
+S21Matrix S21BandedMatrix::solve(const S21Matrix& b) const {
+  if (b.get_rows() != size_) {
+    throw std::invalid_argument("Matrix sizes do not match for solving.");
+  }
+  const Factorization lu = factorize();
+  if (lu.singular) {
+    throw std::invalid_argument("Cannot solve a system with determinant 0.");
+  }
+  const int width = 2 * lower_ + upper_ + 1;
+  auto at = [&lu, width, this](int i, int j) {
+    return lu.lu[static_cast<std::size_t>(i) * width + (j - i + lower_)];
+  };
+  const int cols = b.get_cols();
+  S21Matrix x(b);
+  // L не переставлялась, поэтому перестановки применяются по шагам
+  for (int k = 0; k < size_; ++k) {
+    double* x_k = x.row_data(k);
+    if (lu.pivots[k] != k) {
+      std::swap_ranges(x_k, x_k + cols, x.row_data(lu.pivots[k]));
+    }
+    for (int i = k + 1; i <= std::min(size_ - 1, k + lower_); ++i) {
+      const double factor = at(i, k);
+      double* x_i = x.row_data(i);
+      for (int c = 0; c < cols; ++c) {
+        x_i[c] -= factor * x_k[c];
+      }
+    }
+  }
+  for (int i = size_ - 1; i >= 0; --i) {
+    double* x_i = x.row_data(i);
+    for (int j = i + 1; j <= std::min(size_ - 1, i + lower_ + upper_); ++j) {
+      const double value = at(i, j);
+      const double* x_j = x.row_data(j);
+      for (int c = 0; c < cols; ++c) {
+        x_i[c] -= value * x_j[c];
+      }
+    }
+    const double diagonal = at(i, i);
+    for (int c = 0; c < cols; ++c) {
+      x_i[c] /= diagonal;
+    }
+  }
+  return x;
+}
+
+double& S21BandedMatrix::operator()(int i, int j) {
+  if (i < 0 || i >= size_ || j < 0 || j >= size_) {
+    throw std::out_of_range("Index out of bounds");
+  }
+  if (!in_structure(i, j)) {
+    throw std::out_of_range("Element is outside the band");
+  }
+  return data_[static_cast<std::size_t>(i) * (lower_ + upper_ + 1) +
+               (j - i + lower_)];
+}
+
+double S21BandedMatrix::operator()(int i, int j) const {
+  if (i < 0 || i >= size_ || j < 0 || j >= size_) {
+    throw std::out_of_range("Index out of bounds");
+  }
+  if (!in_structure(i, j)) {
+    return 0.0;
+  }
+  return data_[static_cast<std::size_t>(i) * (lower_ + upper_ + 1) +
+               (j - i + lower_)];
+}
@@ -0,0 +1,114 @@
+#ifndef S21STRUCTUREDMATRIX_H
+#define S21STRUCTUREDMATRIX_H
+
+#include <cstddef>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Симметричная матрица: хранится только верхний треугольник построчно
+// (n(n+1)/2 элементов), a(i, j) и a(j, i) - один и тот же элемент.
+class S21SymmetricMatrix {
+ public:
+  explicit S21SymmetricMatrix(int size);
+  // берётся верхний треугольник квадратной матрицы
+  explicit S21SymmetricMatrix(const S21Matrix& matrix);
+
+  // A * A^T: считается только верхний треугольник
+  static S21SymmetricMatrix syrk(const S21Matrix& a);
+
+  int get_size() const noexcept;
+  std::size_t get_storage_size() const noexcept;
+
+  S21Matrix to_matrix() const;
+  S21Matrix mul_matrix(const S21Matrix& other) const;
+  // this += alpha * A * A^T
+  void rank_k_update(const S21Matrix& a, double alpha = 1.0);
+  // через упакованное LDL^T (Банч-Кауфман), без плотной копии
+  double determinant() const;
+
+  double& operator()(int i, int j);
+  const double& operator()(int i, int j) const;
+
+ private:
+  std::size_t index(int i, int j) const noexcept;
+
+  int size_;
+  std::vector<double> data_;
+};
+
+// Верхне- или нижнетреугольная матрица в упакованном виде.
+class S21TriangularMatrix {
+ public:
+  explicit S21TriangularMatrix(int size, bool upper = true);
+  // берётся соответствующий треугольник квадратной матрицы
+  explicit S21TriangularMatrix(const S21Matrix& matrix, bool upper = true);
+
+  int get_size() const noexcept;
+  bool is_upper() const noexcept;
+  std::size_t get_storage_size() const noexcept;
+
+  S21Matrix to_matrix() const;
+  S21TriangularMatrix transpose() const;
+  S21Matrix mul_matrix(const S21Matrix& other) const;
+  // произведение диагонали, O(n)
+  double determinant() const noexcept;
+  // решение T * X = B прямой или обратной подстановкой
+  S21Matrix solve(const S21Matrix& b) const;
+
+  // запись вне треугольника бросает исключение
+  double& operator()(int i, int j);
+  double operator()(int i, int j) const;
+
+ private:
+  bool in_structure(int i, int j) const noexcept;
+  std::size_t index(int i, int j) const noexcept;
+
+  int size_;
+  bool upper_;
+  std::vector<double> data_;
+};
+
+// Ленточная матрица с lower поддиагоналями и upper наддиагоналями.
+// Строка i хранит элементы столбцов [i - lower, i + upper].
+class S21BandedMatrix {
+ public:
+  S21BandedMatrix(int size, int lower, int upper);
+  // берутся элементы внутри ленты квадратной матрицы
+  S21BandedMatrix(const S21Matrix& matrix, int lower, int upper);
+
+  int get_size() const noexcept;
+  int get_lower() const noexcept;
+  int get_upper() const noexcept;
+  std::size_t get_storage_size() const noexcept;
+
+  S21Matrix to_matrix() const;
+  S21Matrix mul_matrix(const S21Matrix& other) const;
+  // ленточное LU с выбором ведущего элемента, O(n * lower * (lower+upper))
+  double determinant() const;
+  S21Matrix solve(const S21Matrix& b) const;
+
+  // запись вне ленты бросает исключение
+  double& operator()(int i, int j);
+  double operator()(int i, int j) const;
+
+ private:
+  // LU хранится в ленте ширины 2 * lower + upper + 1: перестановки строк
+  // расширяют U на lower наддиагоналей.
+  struct Factorization {
+    std::vector<double> lu;
+    std::vector<int> pivots;
+    int sign = 1;
+    bool singular = false;
+  };
+
+  bool in_structure(int i, int j) const noexcept;
+  Factorization factorize() const;
+
+  int size_;
+  int lower_;
+  int upper_;
+  std::vector<double> data_;
+};
+
+#endif  // S21STRUCTUREDMATRIX_H
@@ -0,0 +1,113 @@
+#include "s21_thread_pool.h"
+
+thread_local S21ThreadPool* S21ThreadPool::current_pool_ = nullptr;
+thread_local unsigned S21ThreadPool::current_index_ = 0;
+
+S21ThreadPool::S21ThreadPool(unsigned threads)
+    : stop_(false),
+      pending_(0),
+      next_queue_(0),
+      link_(std::make_shared<Link>()) {
+  link_->pool = this;
+  if (threads == 0) {
+    threads = 1;
+  }
+  for (unsigned i = 0; i < threads; ++i) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  for (unsigned i = 0; i < threads; ++i) {
+    workers_.emplace_back(&S21ThreadPool::worker_loop, this, i);
+  }
+}
+
+S21ThreadPool::~S21ThreadPool() {
+  {
+    // ждущие потоки submit_after больше не кладут задачи в пул
+    std::lock_guard<std::mutex> lock(link_->mutex);
+    link_->pool = nullptr;
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+S21ThreadPool& S21ThreadPool::instance() {
+  static S21ThreadPool pool;
+  return pool;
+}
+
+unsigned S21ThreadPool::get_threads() const noexcept {
+  return static_cast<unsigned>(workers_.size());
+}
+
+bool S21ThreadPool::run_pending_task() {
+  std::function<void()> task;
+  bool found = pop(task);
+  if (found) {
+    task();
+  }
+  return found;
+}
+
+void S21ThreadPool::push(std::function<void()> task) {
+  // задачи из воркера кладутся в его собственную очередь
+  unsigned index = (current_pool_ == this)
+                       ? current_index_
+                       : next_queue_++ % static_cast<unsigned>(queues_.size());
+  {
+    std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+    queues_[index]->tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    ++pending_;
+  }
+  wake_.notify_one();
+}
+
+bool S21ThreadPool::pop(std::function<void()>& task) {
+  const unsigned count = static_cast<unsigned>(queues_.size());
+  const unsigned own = (current_pool_ == this) ? current_index_ : 0;
+  bool found = false;
+  {
+    std::lock_guard<std::mutex> lock(queues_[own]->mutex);
+    if (!queues_[own]->tasks.empty()) {
+      task = std::move(queues_[own]->tasks.back());
+      queues_[own]->tasks.pop_back();
+      found = true;
+    }
+  }
+  for (unsigned k = 1; k < count && !found; ++k) {
+    Queue& victim = *queues_[(own + k) % count];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      found = true;
+    }
+  }
+  if (found) {
+    --pending_;
+  }
+  return found;
+}
+
+void S21ThreadPool::worker_loop(unsigned index) {
+  current_pool_ = this;
+  current_index_ = index;
+  while (true) {
+    if (run_pending_task()) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    wake_.wait(lock, [this] { return stop_ || pending_ > 0; });
+    if (stop_ && pending_ <= 0) {
+      break;
+    }
+  }
+}
@@ -0,0 +1,179 @@
+#ifndef S21THREADPOOL_H
+#define S21THREADPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Пул потоков с work-stealing: у каждого воркера своя очередь, задачи
+// берутся с конца своей очереди и воруются с начала чужих.
+class S21ThreadPool {
+ public:
+  explicit S21ThreadPool(
+      unsigned threads = std::thread::hardware_concurrency());
+  S21ThreadPool(const S21ThreadPool& other) = delete;
+  S21ThreadPool& operator=(const S21ThreadPool& other) = delete;
+  ~S21ThreadPool();
+
+  static S21ThreadPool& instance();
+
+  unsigned get_threads() const noexcept;
+
+  template <class F>
+  std::future<std::invoke_result_t<F>> submit(F&& task);
+
+  // Задача попадает в очередь только когда все shared_future из deps
+  // готовы, поэтому воркер никогда не ждёт внутри задачи её входы.
+  // Неготовые входы ждёт отдельный поток, заблокированный до завершения
+  // производителя, а не опрашивающий его. Входы std::launch::deferred
+  // отвергаются: они не станут готовы, пока их кто-нибудь не дождётся.
+  // Если пул разрушен раньше, задача отбрасывается (broken_promise).
+  template <class F, class... Futures>
+  std::future<std::invoke_result_t<F>> submit_after(F&& task,
+                                                    Futures... deps);
+
+  // Ожидание с помощью: пока результат не готов, поток выполняет чужие
+  // задачи. Годится только для задач, которые сами не ждут других.
+  template <class Future>
+  void wait(const Future& future);
+
+  bool run_pending_task();
+
+  // Делит [begin, end) на куски не меньше grain и выполняет body(lo, hi)
+  // параллельно; первый кусок выполняет вызывающий поток.
+  template <class F>
+  void parallel_for(int begin, int end, int grain, F&& body);
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  // связь ждущих потоков с пулом, обнуляется в деструкторе
+  struct Link {
+    std::mutex mutex;
+    S21ThreadPool* pool;
+  };
+
+  void push(std::function<void()> task);
+  bool pop(std::function<void()>& task);
+  void worker_loop(unsigned index);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> workers_;
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  std::atomic<bool> stop_;
+  std::atomic<int> pending_;
+  std::atomic<unsigned> next_queue_;
+  std::shared_ptr<Link> link_;
+
+  static thread_local S21ThreadPool* current_pool_;
+  static thread_local unsigned current_index_;
+};
+
+template <class F>
+std::future<std::invoke_result_t<F>> S21ThreadPool::submit(F&& task) {
+  using Result = std::invoke_result_t<F>;
+  auto packaged =
+      std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+  std::future<Result> result = packaged->get_future();
+  push([packaged]() { (*packaged)(); });
+  return result;
+}
+
+template <class F, class... Futures>
+std::future<std::invoke_result_t<F>> S21ThreadPool::submit_after(
+    F&& task, Futures... deps) {
+  using Result = std::invoke_result_t<F>;
+  auto packaged =
+      std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+  const bool deferred = ((deps.wait_for(std::chrono::seconds(0)) ==
+                          std::future_status::deferred) ||
+                         ...);
+  if (deferred) {
+    throw std::invalid_argument("Deferred futures cannot be task inputs.");
+  }
+  std::future<Result> result = packaged->get_future();
+  std::function<void()> run = [packaged]() { (*packaged)(); };
+  const bool ready = ((deps.wait_for(std::chrono::seconds(0)) ==
+                       std::future_status::ready) &&
+                      ...);
+  if (ready) {
+    push(std::move(run));
+  } else {
+    std::thread([link = link_, run = std::move(run), deps...]() mutable {
+      (deps.wait(), ...);
+      std::lock_guard<std::mutex> lock(link->mutex);
+      if (link->pool != nullptr) {
+        link->pool->push(std::move(run));
+      }
+    }).detach();
+  }
+  return result;
+}
+
+template <class Future>
+void S21ThreadPool::wait(const Future& future) {
+  while (future.wait_for(std::chrono::seconds(0)) !=
+         std::future_status::ready) {
+    if (!run_pending_task()) {
+      future.wait_for(std::chrono::microseconds(100));
+    }
+  }
+}
+
+template <class F>
+void S21ThreadPool::parallel_for(int begin, int end, int grain, F&& body) {
+  if (grain < 1) {
+    grain = 1;
+  }
+  int chunks = (end - begin + grain - 1) / grain;
+  chunks = std::min(chunks, static_cast<int>(get_threads()) + 1);
+  if (chunks <= 1) {
+    if (begin < end) {
+      body(begin, end);
+    }
+    return;
+  }
+  const int step = (end - begin + chunks - 1) / chunks;
+  std::vector<std::future<void>> parts;
+  for (int lo = begin + step; lo < end; lo += step) {
+    const int hi = std::min(lo + step, end);
+    parts.push_back(submit([&body, lo, hi]() { body(lo, hi); }));
+  }
+  // куски ссылаются на body, поэтому дожидаемся всех даже при исключении
+  std::exception_ptr error;
+  try {
+    body(begin, std::min(begin + step, end));
+  } catch (...) {
+    error = std::current_exception();
+  }
+  for (auto& part : parts) {
+    wait(part);
+    try {
+      part.get();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+#endif  // S21THREADPOOL_H
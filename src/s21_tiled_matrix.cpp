@@ -0,0 +1,347 @@
+#include "s21_tiled_matrix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+
+#include "s21_thread_pool.h"
+#include "s21_tuning.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define S21_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace {
+// номер тайла на кривой Мортона: биты ti и tj чередуются
+std::uint64_t morton_code(std::uint32_t ti, std::uint32_t tj) {
+  std::uint64_t code = 0;
+  for (int bit = 0; bit < 32; ++bit) {
+    code |= static_cast<std::uint64_t>((tj >> bit) & 1u) << (2 * bit);
+    code |= static_cast<std::uint64_t>((ti >> bit) & 1u) << (2 * bit + 1);
+  }
+  return code;
+}
+
+using TileUpdate = void (*)(double*, const double*, const double*, int, int);
+
+// C -= L * U для тайлов t x t, у L берутся первые kb столбцов
+void tile_update_portable(double* c, const double* l, const double* u, int t,
+                          int kb) {
+  for (int i = 0; i < t; ++i) {
+    double* c_row = c + static_cast<std::size_t>(i) * t;
+    const double* l_row = l + static_cast<std::size_t>(i) * t;
+    for (int k = 0; k < kb; ++k) {
+      const double l_ik = l_row[k];
+      const double* u_row = u + static_cast<std::size_t>(k) * t;
+      for (int j = 0; j < t; ++j) {
+        c_row[j] -= l_ik * u_row[j];
+      }
+    }
+  }
+}
+
+#ifdef S21_X86_KERNELS
+// при -O2 цикл не векторизуется; восемь элементов строки C держатся
+// в регистрах на всём проходе по k
+__attribute__((target("avx2,fma"))) void tile_update_avx2(double* c,
+                                                          const double* l,
+                                                          const double* u,
+                                                          int t, int kb) {
+  for (int i = 0; i < t; ++i) {
+    double* c_row = c + static_cast<std::size_t>(i) * t;
+    const double* l_row = l + static_cast<std::size_t>(i) * t;
+    int j = 0;
+    for (; j + 8 <= t; j += 8) {
+      __m256d acc0 = _mm256_loadu_pd(c_row + j);
+      __m256d acc1 = _mm256_loadu_pd(c_row + j + 4);
+      for (int k = 0; k < kb; ++k) {
+        const __m256d l_ik = _mm256_set1_pd(l_row[k]);
+        const double* u_row = u + static_cast<std::size_t>(k) * t + j;
+        acc0 = _mm256_fnmadd_pd(l_ik, _mm256_loadu_pd(u_row), acc0);
+        acc1 = _mm256_fnmadd_pd(l_ik, _mm256_loadu_pd(u_row + 4), acc1);
+      }
+      _mm256_storeu_pd(c_row + j, acc0);
+      _mm256_storeu_pd(c_row + j + 4, acc1);
+    }
+    for (int k = 0; k < kb && j < t; ++k) {
+      const double l_ik = l_row[k];
+      const double* u_row = u + static_cast<std::size_t>(k) * t;
+      for (int jj = j; jj < t; ++jj) {
+        c_row[jj] -= l_ik * u_row[jj];
+      }
+    }
+  }
+}
+#endif
+
+TileUpdate select_tile_update() {
+#ifdef S21_X86_KERNELS
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return tile_update_avx2;
+  }
+#endif
+  return tile_update_portable;
+}
+}  // namespace
+
+S21TiledMatrix::S21TiledMatrix(int rows, int cols, int tile,
+                               S21Layout layout)
+    : rows_(rows), cols_(cols), tile_(tile), layout_(layout) {
+  if (rows_ < 1 || cols_ < 1) {
+    throw std::length_error("Matrix dimensions cannot be less than one");
+  }
+  if (tile_ < 1) {
+    throw std::length_error("Tile size cannot be less than one");
+  }
+  tiles_rows_ = (rows_ + tile_ - 1) / tile_;
+  tiles_cols_ = (cols_ + tile_ - 1) / tile_;
+  const std::size_t tiles =
+      static_cast<std::size_t>(tiles_rows_) * tiles_cols_;
+  const std::size_t tile_size = static_cast<std::size_t>(tile_) * tile_;
+  std::vector<std::size_t> order(tiles);
+  std::iota(order.begin(), order.end(), 0);
+  if (layout_ == S21Layout::kMorton) {
+    const int width = tiles_cols_;
+    std::sort(order.begin(), order.end(),
+              [width](std::size_t lhs, std::size_t rhs) {
+                return morton_code(lhs / width, lhs % width) <
+                       morton_code(rhs / width, rhs % width);
+              });
+  }
+  tile_offsets_.resize(tiles);
+  for (std::size_t position = 0; position < tiles; ++position) {
+    tile_offsets_[order[position]] = position * tile_size;
+  }
+  data_.resize(tiles * tile_size, 0.0);
+}
+
+S21TiledMatrix::S21TiledMatrix(const S21Matrix& matrix, int tile,
+                               S21Layout layout)
+    : S21TiledMatrix(matrix.get_rows(), matrix.get_cols(), tile, layout) {
+  for (int ti = 0; ti < tiles_rows_; ++ti) {
+    for (int tj = 0; tj < tiles_cols_; ++tj) {
+      double* dst = tile_ptr(ti, tj);
+      const int rows = std::min(tile_, rows_ - ti * tile_);
+      const int cols = std::min(tile_, cols_ - tj * tile_);
+      for (int i = 0; i < rows; ++i) {
+        std::copy_n(matrix.row_data(ti * tile_ + i) + tj * tile_, cols,
+                    dst + static_cast<std::size_t>(i) * tile_);
+      }
+    }
+  }
+}
+
+int S21TiledMatrix::get_rows() const noexcept { return rows_; }
+
+int S21TiledMatrix::get_cols() const noexcept { return cols_; }
+
+int S21TiledMatrix::get_tile() const noexcept { return tile_; }
+
+S21Layout S21TiledMatrix::get_layout() const noexcept { return layout_; }
+
+S21Matrix S21TiledMatrix::to_matrix() const {
+  S21Matrix result(rows_, cols_);
+  for (int ti = 0; ti < tiles_rows_; ++ti) {
+    for (int tj = 0; tj < tiles_cols_; ++tj) {
+      const double* src = tile_ptr(ti, tj);
+      const int rows = std::min(tile_, rows_ - ti * tile_);
+      const int cols = std::min(tile_, cols_ - tj * tile_);
+      for (int i = 0; i < rows; ++i) {
+        std::copy_n(src + static_cast<std::size_t>(i) * tile_, cols,
+                    result.row_data(ti * tile_ + i) + tj * tile_);
+      }
+    }
+  }
+  return result;
+}
+
+// C(ti, tj) = sum_k A(ti, k) * B(k, tj): все три тайла непрерывны,
+// нулевое дополнение крайних тайлов не влияет на результат.
+S21TiledMatrix S21TiledMatrix::mul_matrix(const S21TiledMatrix& other) const {
+  if (cols_ != other.rows_) {
+    throw std::invalid_argument(
+        "Matrix sizes do not match for multiplication.");
+  }
+  if (tile_ != other.tile_) {
+    throw std::invalid_argument("Tiled matrices must share the tile size.");
+  }
+  S21TiledMatrix result(rows_, other.cols_, tile_, layout_);
+  const int t = tile_;
+  const int tiles_inner = tiles_cols_;
+  const int tiles_j = result.tiles_cols_;
+  auto tiles_block = [&](int lo, int hi) {
+    for (int index = lo; index < hi; ++index) {
+      const int ti = index / tiles_j;
+      const int tj = index % tiles_j;
+      double* c = result.tile_ptr(ti, tj);
+      for (int tk = 0; tk < tiles_inner; ++tk) {
+        const double* a = tile_ptr(ti, tk);
+        const double* b = other.tile_ptr(tk, tj);
+        for (int i = 0; i < t; ++i) {
+          double* c_row = c + static_cast<std::size_t>(i) * t;
+          for (int k = 0; k < t; ++k) {
+            const double a_ik = a[static_cast<std::size_t>(i) * t + k];
+            const double* b_row = b + static_cast<std::size_t>(k) * t;
+            for (int j = 0; j < t; ++j) {
+              c_row[j] += a_ik * b_row[j];
+            }
+          }
+        }
+      }
+    }
+  };
+  const int tiles = result.tiles_rows_ * tiles_j;
+  const double flops = static_cast<double>(tiles) * tiles_inner * t * t * t;
+  if (flops < S21Tuning::get().gemm_parallel_flops) {
+    tiles_block(0, tiles);
+  } else {
+    S21ThreadPool::instance().parallel_for(0, tiles, 1, tiles_block);
+  }
+  return result;
+}
+
+S21TiledMatrix S21TiledMatrix::transpose() const {
+  S21TiledMatrix result(cols_, rows_, tile_, layout_);
+  const int t = tile_;
+  for (int ti = 0; ti < tiles_rows_; ++ti) {
+    for (int tj = 0; tj < tiles_cols_; ++tj) {
+      const double* src = tile_ptr(ti, tj);
+      double* dst = result.tile_ptr(tj, ti);
+      for (int i = 0; i < t; ++i) {
+        for (int j = 0; j < t; ++j) {
+          dst[static_cast<std::size_t>(j) * t + i] =
+              src[static_cast<std::size_t>(i) * t + j];
+        }
+      }
+    }
+  }
+  return result;
+}
+
+// Шаг по тайловому столбцу kt: панель kt раскладывается поэлементно,
+// тайлы U(kt, tj) правее неё решаются с L(kt, kt), затем остаток
+// обновляется произведениями тайлов A(ti, tj) -= L(ti, kt) * U(kt, tj).
+S21LuFactorization S21TiledMatrix::lu_decompose(double pivot_tolerance) const {
+  if (rows_ != cols_) {
+    throw std::invalid_argument(
+        "LU decomposition is defined only for square matrices.");
+  }
+  S21TiledMatrix a(*this);
+  const int n = rows_;
+  const int t = tile_;
+  const int tiles = tiles_rows_;
+  S21LuFactorization result;
+  result.perm.resize(n);
+  std::iota(result.perm.begin(), result.perm.end(), 0);
+  double norm = 0.0;
+  for (int i = 0; i < n; ++i) {
+    double row_sum = 0.0;
+    for (int j = 0; j < n; ++j) {
+      row_sum += std::fabs(a.at_unchecked(i, j));
+    }
+    norm = std::max(norm, row_sum);
+  }
+  const double eps = n * norm * pivot_tolerance;
+  const double lu_parallel_work = S21Tuning::get().lu_parallel_work;
+  // часть строки i внутри тайлового столбца tj непрерывна
+  auto row_in = [&a, t](int i, int tj) {
+    return a.tile_ptr(i / t, tj) + static_cast<std::size_t>(i % t) * t;
+  };
+  for (int kt = 0; kt < tiles; ++kt) {
+    const int k0 = kt * t;
+    const int kb = std::min(t, n - k0);
+    for (int kc = 0; kc < kb; ++kc) {
+      const int k = k0 + kc;
+      int pivot = k;
+      double best = std::fabs(row_in(k, kt)[kc]);
+      for (int i = k + 1; i < n; ++i) {
+        const double value = std::fabs(row_in(i, kt)[kc]);
+        if (value > best) {
+          best = value;
+          pivot = i;
+        }
+      }
+      if (pivot != k) {
+        for (int tj = 0; tj < tiles; ++tj) {
+          std::swap_ranges(row_in(pivot, tj), row_in(pivot, tj) + t,
+                           row_in(k, tj));
+        }
+        std::swap(result.perm[pivot], result.perm[k]);
+        result.sign = -result.sign;
+      }
+      const double* pivot_row = row_in(k, kt);
+      if (std::fabs(pivot_row[kc]) <= eps) {
+        // нулевые множители: блочное обновление столбец не применяет,
+        // как и построчное LU, пропускающее вырожденный шаг
+        result.singular = true;
+        for (int i = k + 1; i < n; ++i) {
+          row_in(i, kt)[kc] = 0.0;
+        }
+        continue;
+      }
+      for (int i = k + 1; i < n; ++i) {
+        double* row = row_in(i, kt);
+        const double factor = row[kc] / pivot_row[kc];
+        row[kc] = factor;
+        for (int j = kc + 1; j < kb; ++j) {
+          row[j] -= factor * pivot_row[j];
+        }
+      }
+    }
+    if (kt + 1 == tiles) {
+      break;
+    }
+    // U(kt, tj) = L(kt, kt)^-1 * A(kt, tj), L с единичной диагональю
+    const double* l_diag = a.tile_ptr(kt, kt);
+    for (int tj = kt + 1; tj < tiles; ++tj) {
+      double* u = a.tile_ptr(kt, tj);
+      for (int r = 1; r < kb; ++r) {
+        double* u_row = u + static_cast<std::size_t>(r) * t;
+        for (int c = 0; c < r; ++c) {
+          const double l_rc = l_diag[static_cast<std::size_t>(r) * t + c];
+          const double* u_src = u + static_cast<std::size_t>(c) * t;
+          for (int j = 0; j < t; ++j) {
+            u_row[j] -= l_rc * u_src[j];
+          }
+        }
+      }
+    }
+    const TileUpdate tile_update = select_tile_update();
+    auto trailing = [&a, t, kt, kb, tiles, tile_update](int lo, int hi) {
+      for (int ti = lo; ti < hi; ++ti) {
+        const double* l = a.tile_ptr(ti, kt);
+        for (int tj = kt + 1; tj < tiles; ++tj) {
+          const double* u = a.tile_ptr(kt, tj);
+          tile_update(a.tile_ptr(ti, tj), l, u, t, kb);
+        }
+      }
+    };
+    // работа на один столбец панели в мере построчного LU,
+    // (n - k - 1) * (n - k) при n - k - 1 = rest
+    const double rest = static_cast<double>(n - k0 - kb);
+    if (rest * (rest + 1) < lu_parallel_work) {
+      trailing(kt + 1, tiles);
+    } else {
+      S21ThreadPool::instance().parallel_for(kt + 1, tiles, 1, trailing);
+    }
+  }
+  result.lu = a.to_matrix();
+  return result;
+}
+
+double& S21TiledMatrix::operator()(int i, int j) {
+  if (i < 0 || i >= rows_ || j < 0 || j >= cols_) {
+    throw std::out_of_range("Index out of bounds");
+  }
+  return at_unchecked(i, j);
+}
+
+const double& S21TiledMatrix::operator()(int i, int j) const {
+  if (i < 0 || i >= rows_ || j < 0 || j >= cols_) {
+    throw std::out_of_range("Index out of bounds");
+  }
+  return at_unchecked(i, j);
+}
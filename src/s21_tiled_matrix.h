@@ -0,0 +1,70 @@
+#ifndef S21TILEDMATRIX_H
+#define S21TILEDMATRIX_H
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Порядок тайлов в памяти: построчно или по кривой Мортона (Z-order).
+enum class S21Layout { kBlocked, kMorton };
+
+// Матрица, хранящая элементы квадратными тайлами tile x tile. Каждый
+// тайл непрерывен в памяти (внутри - построчно), крайние тайлы дополнены
+// нулями. Доступ к элементам скрывает раскладку.
+class S21TiledMatrix {
+ public:
+  S21TiledMatrix(int rows, int cols, int tile = 64,
+                 S21Layout layout = S21Layout::kBlocked);
+  explicit S21TiledMatrix(const S21Matrix& matrix, int tile = 64,
+                          S21Layout layout = S21Layout::kBlocked);
+
+  int get_rows() const noexcept;
+  int get_cols() const noexcept;
+  int get_tile() const noexcept;
+  S21Layout get_layout() const noexcept;
+
+  S21Matrix to_matrix() const;
+  S21TiledMatrix mul_matrix(const S21TiledMatrix& other) const;
+  S21TiledMatrix transpose() const;
+  // Блочное LU с частичным выбором ведущего элемента прямо на тайлах,
+  // порог вырожденности как у S21Matrix::lu_decompose. Результат
+  // переводится в построчную раскладку для solve и inverse.
+  S21LuFactorization lu_decompose(
+      double pivot_tolerance = std::numeric_limits<double>::epsilon()) const;
+
+  double& operator()(int i, int j);
+  const double& operator()(int i, int j) const;
+
+  double& at_unchecked(int i, int j) noexcept {
+    return data_[offset(i / tile_, j / tile_) +
+                 static_cast<std::size_t>(i % tile_) * tile_ + j % tile_];
+  }
+  const double& at_unchecked(int i, int j) const noexcept {
+    return data_[offset(i / tile_, j / tile_) +
+                 static_cast<std::size_t>(i % tile_) * tile_ + j % tile_];
+  }
+
+ private:
+  std::size_t offset(int ti, int tj) const noexcept {
+    return tile_offsets_[static_cast<std::size_t>(ti) * tiles_cols_ + tj];
+  }
+  double* tile_ptr(int ti, int tj) noexcept {
+    return data_.data() + offset(ti, tj);
+  }
+  const double* tile_ptr(int ti, int tj) const noexcept {
+    return data_.data() + offset(ti, tj);
+  }
+
+  int rows_;
+  int cols_;
+  int tile_;
+  int tiles_rows_;
+  int tiles_cols_;
+  S21Layout layout_;
+  std::vector<std::size_t> tile_offsets_;
+  std::vector<double> data_;
+};
+
+#endif  // S21TILEDMATRIX_H
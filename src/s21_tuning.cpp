@@ -0,0 +1,348 @@
+#include "s21_tuning.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+namespace {
+constexpr long kDefaultL1 = 32 * 1024;
+constexpr long kDefaultL2 = 256 * 1024;
+// значение порога, при котором параллельная ветка не выбирается никогда
+constexpr double kNever = std::numeric_limits<double>::max();
+
+struct SharedProfile {
+  std::atomic<int> gemm_block;
+  std::atomic<int> gemm_grain;
+  std::atomic<double> gemm_parallel_flops;
+  std::atomic<int> transpose_block;
+  std::atomic<std::size_t> reduce_parallel_size;
+  std::atomic<double> lu_parallel_work;
+
+  explicit SharedProfile(const S21TuningProfile& profile) { store(profile); }
+
+  void store(const S21TuningProfile& profile) noexcept {
+    gemm_block = profile.gemm_block;
+    gemm_grain = profile.gemm_grain;
+    gemm_parallel_flops = profile.gemm_parallel_flops;
+    transpose_block = profile.transpose_block;
+    reduce_parallel_size = profile.reduce_parallel_size;
+    lu_parallel_work = profile.lu_parallel_work;
+  }
+};
+
+bool is_valid(const S21TuningProfile& profile) {
+  return profile.gemm_block >= 8 && profile.gemm_block <= 4096 &&
+         profile.gemm_grain >= 1 && profile.transpose_block >= 1 &&
+         profile.transpose_block <= 4096 &&
+         profile.gemm_parallel_flops >= 0.0 &&
+         profile.lu_parallel_work >= 0.0;
+}
+
+// Формат файла: строки "ключ значение", строки с # - комментарии.
+bool read_profile(const std::string& path, S21TuningProfile& profile) {
+  std::ifstream in(path);
+  if (!in) {
+    return false;
+  }
+  S21TuningProfile result = profile;
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream fields(line);
+    std::string key;
+    if (!(fields >> key) || key[0] == '#') {
+      continue;
+    }
+    bool parsed = true;
+    if (key == "gemm_block") {
+      parsed = static_cast<bool>(fields >> result.gemm_block);
+    } else if (key == "gemm_grain") {
+      parsed = static_cast<bool>(fields >> result.gemm_grain);
+    } else if (key == "gemm_parallel_flops") {
+      parsed = static_cast<bool>(fields >> result.gemm_parallel_flops);
+    } else if (key == "transpose_block") {
+      parsed = static_cast<bool>(fields >> result.transpose_block);
+    } else if (key == "reduce_parallel_size") {
+      parsed = static_cast<bool>(fields >> result.reduce_parallel_size);
+    } else if (key == "lu_parallel_work") {
+      parsed = static_cast<bool>(fields >> result.lu_parallel_work);
+    }
+    if (!parsed) {
+      return false;
+    }
+  }
+  if (!is_valid(result)) {
+    return false;
+  }
+  profile = result;
+  return true;
+}
+
+S21TuningProfile initial_profile() {
+  S21TuningProfile profile = S21Tuning::heuristic();
+  try {
+    read_profile(S21Tuning::default_path(), profile);
+  } catch (...) {
+    // без профиля остаются эвристики
+  }
+  return profile;
+}
+
+SharedProfile& shared() {
+  static SharedProfile profile(initial_profile());
+  return profile;
+}
+
+long cache_size(int name, long fallback) {
+  const long size = sysconf(name);
+  return size > 0 ? size : fallback;
+}
+
+// Время одного запуска в секундах, лучшее из нескольких замеров.
+// Короткие операции повторяются пачкой, чтобы замер не тонул в шуме.
+template <class F>
+double best_time(F run, int repeats = 3) {
+  constexpr double kMinSample = 2e-3;
+  auto measure = [&run](int iterations) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int it = 0; it < iterations; ++it) {
+      run();
+    }
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+  };
+  int iterations = 1;
+  double sample = measure(iterations);
+  while (sample < kMinSample && iterations < (1 << 20)) {
+    iterations *= 2;
+    sample = measure(iterations);
+  }
+  double best = sample / iterations;
+  for (int r = 1; r < repeats; ++r) {
+    best = std::min(best, measure(iterations) / iterations);
+  }
+  return best;
+}
+
+S21Matrix make_tuning_matrix(int rows, int cols) {
+  S21Matrix m(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      m(i, j) = (i == j) ? rows + 1.0 : 1.0 / (1 + (i * 7 + j * 3) % 11);
+    }
+  }
+  return m;
+}
+
+// Перебор одного параметра: остальные берутся из profile, лучший
+// кандидат записывается обратно.
+template <class T, class F>
+void sweep(S21TuningProfile& profile, T S21TuningProfile::*field,
+           const std::vector<T>& candidates, F run) {
+  double best = std::numeric_limits<double>::max();
+  T best_value = profile.*field;
+  for (T value : candidates) {
+    S21TuningProfile trial = profile;
+    trial.*field = value;
+    S21Tuning::set(trial);
+    const double time = best_time(run);
+    if (time < best) {
+      best = time;
+      best_value = value;
+    }
+  }
+  profile.*field = best_value;
+  S21Tuning::set(profile);
+}
+
+// Наименьший размер из sizes, на котором параллельная версия заметно
+// быстрее последовательной; kNever, если такого нет.
+template <class F>
+double parallel_threshold(S21TuningProfile& profile,
+                          double S21TuningProfile::*field,
+                          const std::vector<int>& sizes, F run_for_size) {
+  for (int size : sizes) {
+    S21TuningProfile trial = profile;
+    trial.*field = kNever;
+    S21Tuning::set(trial);
+    const double serial = best_time([&] { run_for_size(size); });
+    trial.*field = 0.0;
+    S21Tuning::set(trial);
+    const double parallel = best_time([&] { run_for_size(size); });
+    if (parallel < 0.9 * serial) {
+      return size;
+    }
+  }
+  return kNever;
+}
+}  // namespace
+
+S21TuningProfile S21Tuning::get() noexcept {
+  SharedProfile& profile = shared();
+  S21TuningProfile result;
+  result.gemm_block = profile.gemm_block.load(std::memory_order_relaxed);
+  result.gemm_grain = profile.gemm_grain.load(std::memory_order_relaxed);
+  result.gemm_parallel_flops =
+      profile.gemm_parallel_flops.load(std::memory_order_relaxed);
+  result.transpose_block =
+      profile.transpose_block.load(std::memory_order_relaxed);
+  result.reduce_parallel_size =
+      profile.reduce_parallel_size.load(std::memory_order_relaxed);
+  result.lu_parallel_work =
+      profile.lu_parallel_work.load(std::memory_order_relaxed);
+  return result;
+}
+
+void S21Tuning::set(const S21TuningProfile& profile) {
+  if (!is_valid(profile)) {
+    throw std::invalid_argument("Invalid tuning profile.");
+  }
+  shared().store(profile);
+}
+
+S21TuningProfile S21Tuning::heuristic() {
+  long l1 = kDefaultL1;
+  long l2 = kDefaultL2;
+#if defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE)
+  l1 = cache_size(_SC_LEVEL1_DCACHE_SIZE, kDefaultL1);
+  l2 = cache_size(_SC_LEVEL2_CACHE_SIZE, kDefaultL2);
+#endif
+  S21TuningProfile profile;
+  // блок B занимает четверть L2, остальное - строки A и C
+  int gemm_block = static_cast<int>(std::sqrt(l2 / 4.0 / sizeof(double)));
+  profile.gemm_block = std::clamp(gemm_block / 16 * 16, 32, 256);
+  // два блока транспонирования помещаются в L1
+  int transpose_block = 8;
+  while (transpose_block < 128 &&
+         2.0 * (2 * transpose_block) * (2 * transpose_block) *
+                 sizeof(double) <=
+             l1) {
+    transpose_block *= 2;
+  }
+  profile.transpose_block = transpose_block;
+  return profile;
+}
+
+std::string S21Tuning::default_path() {
+  if (const char* path = std::getenv("S21_TUNING_PROFILE")) {
+    return path;
+  }
+  if (const char* home = std::getenv("HOME")) {
+    return std::string(home) + "/.s21_matrix_tuning";
+  }
+  return ".s21_matrix_tuning";
+}
+
+bool S21Tuning::load(const std::string& path) {
+  S21TuningProfile profile = get();
+  if (!read_profile(path, profile)) {
+    return false;
+  }
+  set(profile);
+  return true;
+}
+
+void S21Tuning::save(const std::string& path) {
+  const S21TuningProfile profile = get();
+  std::ofstream out(path);
+  out.precision(std::numeric_limits<double>::max_digits10);
+  out << "# s21_matrix tuning profile\n"
+      << "gemm_block " << profile.gemm_block << '\n'
+      << "gemm_grain " << profile.gemm_grain << '\n'
+      << "gemm_parallel_flops " << profile.gemm_parallel_flops << '\n'
+      << "transpose_block " << profile.transpose_block << '\n'
+      << "reduce_parallel_size " << profile.reduce_parallel_size << '\n'
+      << "lu_parallel_work " << profile.lu_parallel_work << '\n';
+  if (!out) {
+    throw std::runtime_error("Cannot write tuning profile " + path);
+  }
+}
+
+S21TuningProfile S21Tuning::autotune(int size) {
+  if (size < 16) {
+    throw std::invalid_argument("Tuning size cannot be less than 16.");
+  }
+  S21TuningProfile profile = get();
+  const S21Matrix a = make_tuning_matrix(size, size);
+  const S21Matrix b = make_tuning_matrix(size, size);
+  auto multiply = [&a, &b] { S21Matrix c = a * b; };
+
+  // блоки подбираются без параллельности, чтобы не мешал шум пула
+  S21TuningProfile serial = profile;
+  serial.gemm_parallel_flops = kNever;
+  std::vector<int> gemm_blocks;
+  for (int block : {16, 32, 48, 64, 96, 128, 192, 256}) {
+    if (block <= size) {
+      gemm_blocks.push_back(block);
+    }
+  }
+  sweep(serial, &S21TuningProfile::gemm_block, gemm_blocks, multiply);
+  profile.gemm_block = serial.gemm_block;
+
+  const S21Matrix wide = make_tuning_matrix(2 * size, 2 * size);
+  sweep(profile, &S21TuningProfile::transpose_block,
+        std::vector<int>{8, 16, 32, 64, 128},
+        [&wide] { S21Matrix t = wide.transpose(); });
+
+  std::vector<int> sizes;
+  for (int n = 16; n <= size; n *= 2) {
+    sizes.push_back(n);
+  }
+  const double gemm_size = parallel_threshold(
+      profile, &S21TuningProfile::gemm_parallel_flops, sizes, [](int n) {
+        S21Matrix m = make_tuning_matrix(n, n);
+        S21Matrix c = m * m;
+      });
+  profile.gemm_parallel_flops =
+      gemm_size == kNever ? kNever : gemm_size * gemm_size * gemm_size;
+  if (profile.gemm_parallel_flops != kNever) {
+    S21TuningProfile parallel = profile;
+    parallel.gemm_parallel_flops = 0.0;
+    sweep(parallel, &S21TuningProfile::gemm_grain,
+          std::vector<int>{4, 8, 16, 32, 64}, multiply);
+    profile.gemm_grain = parallel.gemm_grain;
+  }
+
+  const double lu_size = parallel_threshold(
+      profile, &S21TuningProfile::lu_parallel_work, sizes, [](int n) {
+        S21Matrix m = make_tuning_matrix(n, n);
+        m.determinant();
+      });
+  // та же мера, что в lu_decompose: первый шаг обновляет (n - 1) * n
+  profile.lu_parallel_work =
+      lu_size == kNever ? kNever : (lu_size - 1) * lu_size;
+
+  // порог редукций ищется по длине вектора
+  std::size_t reduce_size = std::numeric_limits<std::size_t>::max();
+  const S21Matrix column = make_tuning_matrix(4 * size * size, 1);
+  const std::size_t length = static_cast<std::size_t>(column.get_rows());
+  for (std::size_t n = 1 << 12; n <= length; n *= 4) {
+    S21Matrix part(static_cast<int>(n), 1);
+    std::copy_n(column.data(), n, part.data());
+    S21TuningProfile trial = profile;
+    trial.reduce_parallel_size = std::numeric_limits<std::size_t>::max();
+    set(trial);
+    const double serial_time = best_time([&part] { part.sum(); });
+    trial.reduce_parallel_size = 0;
+    set(trial);
+    const double parallel_time = best_time([&part] { part.sum(); });
+    if (parallel_time < 0.9 * serial_time) {
+      reduce_size = n;
+      break;
+    }
+  }
+  profile.reduce_parallel_size = reduce_size;
+  set(profile);
+  return profile;
+}
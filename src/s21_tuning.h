@@ -0,0 +1,45 @@
+#ifndef S21TUNING_H
+#define S21TUNING_H
+
+#include <cstddef>
+#include <string>
+
+// Параметры блочных и параллельных ядер S21Matrix.
+struct S21TuningProfile {
+  // блок по внутреннему измерению и по столбцам результата для умножения
+  int gemm_block = 64;
+  // строк результата на одну задачу пула при параллельном умножении
+  int gemm_grain = 16;
+  // начиная с такого числа операций умножение распараллеливается
+  double gemm_parallel_flops = 64.0 * 64.0 * 64.0;
+  // размер блока при транспонировании
+  int transpose_block = 32;
+  // редукции по большему числу элементов делятся между потоками
+  std::size_t reduce_parallel_size = 1 << 16;
+  // шаг LU, обновляющий больше элементов, выполняется параллельно
+  double lu_parallel_work = 256.0 * 256.0;
+};
+
+// Текущий профиль настройки. При первом обращении профиль читается из
+// default_path(), а если файла нет - выводится из размеров кэшей.
+class S21Tuning {
+ public:
+  static S21TuningProfile get() noexcept;
+  static void set(const S21TuningProfile& profile);
+
+  // блоки подбираются под размеры L1 и L2 из sysconf
+  static S21TuningProfile heuristic();
+  // $S21_TUNING_PROFILE или ~/.s21_matrix_tuning
+  static std::string default_path();
+
+  // false, если файл не читается или содержит недопустимые значения;
+  // текущий профиль тогда не меняется
+  static bool load(const std::string& path);
+  static void save(const std::string& path);
+
+  // Перебирает параметры на матрицах порядка size, устанавливает и
+  // возвращает лучший профиль.
+  static S21TuningProfile autotune(int size = 256);
+};
+
+#endif  // S21TUNING_H
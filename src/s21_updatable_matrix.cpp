@@ -0,0 +1,94 @@
+#include "s21_updatable_matrix.h"
+
+#include <algorithm>
+#include <cmath>
+
+S21UpdatableMatrix::S21UpdatableMatrix(const S21Matrix& matrix,
+                                       double drift_tolerance)
+    : matrix_(matrix),
+      determinant_(0.0),
+      drift_tolerance_(drift_tolerance),
+      refactorizations_(0) {
+  refactorize();
+}
+
+const S21Matrix& S21UpdatableMatrix::get_matrix() const noexcept {
+  return matrix_;
+}
+
+const S21Matrix& S21UpdatableMatrix::get_inverse() const noexcept {
+  return inverse_;
+}
+
+double S21UpdatableMatrix::determinant() const noexcept {
+  return determinant_;
+}
+
+int S21UpdatableMatrix::get_refactorizations() const noexcept {
+  return refactorizations_;
+}
+
+void S21UpdatableMatrix::rank1_update(const S21Matrix& u, const S21Matrix& v) {
+  if (u.get_cols() != 1 || v.get_cols() != 1) {
+    throw std::invalid_argument("Rank-1 update expects column vectors.");
+  }
+  rank_k_update(u, v);
+}
+
+void S21UpdatableMatrix::rank_k_update(const S21Matrix& u,
+                                       const S21Matrix& v) {
+  const int n = matrix_.get_rows();
+  if (u.get_rows() != n || v.get_rows() != n ||
+      u.get_cols() != v.get_cols()) {
+    throw std::invalid_argument("Matrix sizes do not match for update.");
+  }
+  const int k = u.get_cols();
+  S21Matrix v_t = v.transpose();
+  S21Matrix w = inverse_ * u;    // A^-1 U, n x k
+  S21Matrix z = v_t * inverse_;  // V^T A^-1, k x n
+  S21Matrix capacitance = v_t * w;
+  for (int i = 0; i < k; ++i) {
+    capacitance(i, i) += 1.0;
+  }
+  S21LuFactorization small = capacitance.lu_decompose();
+  if (small.singular) {
+    throw std::invalid_argument(
+        "Update makes the matrix singular (determinant 0).");
+  }
+  // сначала считаем всё во временных, чтобы исключение не испортило объект
+  S21Matrix inverse = inverse_ - w * small.solve(z);
+  S21Matrix matrix = matrix_ + u * v_t;
+  double det = determinant_ * small.determinant();
+  matrix_ = std::move(matrix);
+  inverse_ = std::move(inverse);
+  determinant_ = det;
+  if (drift() > drift_tolerance_) {
+    refactorize();
+  }
+}
+
+void S21UpdatableMatrix::refactorize() {
+  S21LuFactorization lu = matrix_.lu_decompose();
+  if (lu.singular) {
+    throw std::invalid_argument(
+        "Cannot maintain inverse for a matrix with determinant 0.");
+  }
+  inverse_ = lu.inverse();
+  determinant_ = lu.determinant();
+  ++refactorizations_;
+}
+
+// Невязка ||A * (A^-1 * x) - x||_inf для x из единиц, O(n^2).
+double S21UpdatableMatrix::drift() const {
+  const int n = matrix_.get_rows();
+  S21Matrix ones(n, 1);
+  for (int i = 0; i < n; ++i) {
+    ones(i, 0) = 1.0;
+  }
+  S21Matrix residual = matrix_ * (inverse_ * ones) - ones;
+  double result = 0.0;
+  for (int i = 0; i < n; ++i) {
+    result = std::max(result, std::fabs(residual(i, 0)));
+  }
+  return result;
+}
@@ -0,0 +1,33 @@
+#ifndef S21UPDATABLEMATRIX_H
+#define S21UPDATABLEMATRIX_H
+
+#include "s21_matrix_oop.h"
+
+// Матрица с поддерживаемыми обратной матрицей и определителем.
+// Обновления A += u * v^T и A += U * V^T пересчитываются по формулам
+// Шермана-Моррисона-Вудбери за O(n^2 * k) вместо O(n^3).
+class S21UpdatableMatrix {
+ public:
+  explicit S21UpdatableMatrix(const S21Matrix& matrix,
+                              double drift_tolerance = 1e-9);
+
+  const S21Matrix& get_matrix() const noexcept;
+  const S21Matrix& get_inverse() const noexcept;
+  double determinant() const noexcept;
+  int get_refactorizations() const noexcept;
+
+  void rank1_update(const S21Matrix& u, const S21Matrix& v);
+  void rank_k_update(const S21Matrix& u, const S21Matrix& v);
+  void refactorize();
+
+ private:
+  double drift() const;
+
+  S21Matrix matrix_;
+  S21Matrix inverse_;
+  double determinant_;
+  double drift_tolerance_;
+  int refactorizations_;
+};
+
+#endif  // S21UPDATABLEMATRIX_H
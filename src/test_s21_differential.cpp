@@ -0,0 +1,623 @@
+// Дифференциальные тесты: оптимизированные ядра (блочные, параллельные,
+// SIMD, LU) сравниваются с прямыми циклами в long double на случайных
+// формах - хвостах блоков, вырожденных размерах, плохо обусловленных
+// данных. Нарушение свойства сжимается до минимального случая.
+// S21_DIFFERENTIAL_SEED задаёт начальное значение генератора.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "s21_kronecker.h"
+#include "s21_matrix_oop.h"
+#include "s21_mixed_solver.h"
+#include "s21_quantized_matrix.h"
+#include "s21_structured_matrix.h"
+#include "s21_tiled_matrix.h"
+#include "s21_tuning.h"
+
+namespace {
+constexpr double kEps = std::numeric_limits<double>::epsilon();
+constexpr int kCases = 30;
+// размеры вокруг ширины векторов и блоков
+constexpr int kEdgeSizes[] = {1, 2, 3, 4, 7, 8, 9, 15, 16, 17, 31, 33, 63, 65};
+
+enum class Fill { kUniform, kIntegers, kScaled, kNearSingular };
+
+struct Case {
+  std::array<int, 3> dims;
+  Fill fill;
+  std::uint64_t seed;
+};
+
+// пустая строка - свойство выполнено, иначе описание расхождения
+using Property = std::function<std::string(const Case&)>;
+
+std::string describe(const Case& c) {
+  std::ostringstream out;
+  out << "dims " << c.dims[0] << "x" << c.dims[1] << "x" << c.dims[2]
+      << ", fill " << static_cast<int>(c.fill) << ", seed " << c.seed;
+  return out.str();
+}
+
+std::uint64_t base_seed() {
+  const char* env = std::getenv("S21_DIFFERENTIAL_SEED");
+  return env ? std::strtoull(env, nullptr, 10) : 20240601u;
+}
+
+// оценка ошибки рекурсивного суммирования k слагаемых
+double gamma(int k) { return k * kEps / (1.0 - k * kEps); }
+
+S21Matrix make_matrix(int rows, int cols, Fill fill, std::uint64_t seed) {
+  std::mt19937_64 generator(seed);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  S21Matrix m(rows, cols);
+  if (fill == Fill::kNearSingular) {
+    // ранг 1 плюс возмущение порядка 1e-10
+    std::vector<double> u(rows);
+    std::vector<double> v(cols);
+    for (double& x : u) {
+      x = uniform(generator);
+    }
+    for (double& x : v) {
+      x = uniform(generator);
+    }
+    for (int i = 0; i < rows; ++i) {
+      for (int j = 0; j < cols; ++j) {
+        m(i, j) = u[i] * v[j] + 1e-10 * uniform(generator);
+      }
+    }
+    return m;
+  }
+  std::uniform_int_distribution<int> small(-3, 3);
+  std::uniform_int_distribution<int> exponent(-8, 8);
+  for (int i = 0; i < rows; ++i) {
+    // строки с разными порядками величин
+    const double scale =
+        fill == Fill::kScaled ? std::pow(10.0, exponent(generator)) : 1.0;
+    for (int j = 0; j < cols; ++j) {
+      m(i, j) = fill == Fill::kIntegers ? small(generator)
+                                        : scale * uniform(generator);
+    }
+  }
+  return m;
+}
+
+int random_dim(std::mt19937_64& generator, int max_dim) {
+  std::uniform_int_distribution<int> coin(0, 1);
+  if (coin(generator)) {
+    std::vector<int> edges;
+    for (int size : kEdgeSizes) {
+      if (size <= max_dim) {
+        edges.push_back(size);
+      }
+    }
+    std::uniform_int_distribution<std::size_t> pick(0, edges.size() - 1);
+    return edges[pick(generator)];
+  }
+  return std::uniform_int_distribution<int>(1, max_dim)(generator);
+}
+
+// Жадное сжатие: размеры уменьшаются до 1, вдвое или на единицу,
+// данные упрощаются до равномерных, пока свойство нарушается.
+Case shrink(Case failing, const Property& property) {
+  bool progress = true;
+  while (progress) {
+    progress = false;
+    for (std::size_t d = 0; d < failing.dims.size(); ++d) {
+      const int dim = failing.dims[d];
+      for (int candidate : {1, dim / 2, dim - 1}) {
+        if (candidate < 1 || candidate >= failing.dims[d]) {
+          continue;
+        }
+        Case smaller = failing;
+        smaller.dims[d] = candidate;
+        if (!property(smaller).empty()) {
+          failing = smaller;
+          progress = true;
+        }
+      }
+    }
+    if (failing.fill != Fill::kUniform) {
+      Case simpler = failing;
+      simpler.fill = Fill::kUniform;
+      if (!property(simpler).empty()) {
+        failing = simpler;
+        progress = true;
+      }
+    }
+  }
+  return failing;
+}
+
+void check_property(const Property& property, int max_dim) {
+  std::mt19937_64 generator(base_seed());
+  std::uniform_int_distribution<int> fill(0, 3);
+  for (int t = 0; t < kCases; ++t) {
+    Case c{{random_dim(generator, max_dim), random_dim(generator, max_dim),
+            random_dim(generator, max_dim)},
+           static_cast<Fill>(fill(generator)),
+           generator()};
+    if (!property(c).empty()) {
+      const Case minimal = shrink(c, property);
+      ADD_FAILURE() << "minimal case " << describe(minimal) << ": "
+                    << property(minimal) << " (original " << describe(c)
+                    << ")";
+      return;
+    }
+  }
+}
+
+// Эталоны: прямые циклы с накоплением в long double.
+struct Reference {
+  std::vector<long double> value;
+  // |A| * |B| для оценки ошибки
+  std::vector<double> magnitude;
+};
+
+Reference reference_mul(const S21Matrix& a, const S21Matrix& b) {
+  const int m = a.get_rows();
+  const int k = a.get_cols();
+  const int n = b.get_cols();
+  Reference ref{std::vector<long double>(static_cast<std::size_t>(m) * n),
+                std::vector<double>(static_cast<std::size_t>(m) * n)};
+  for (int i = 0; i < m; ++i) {
+    for (int j = 0; j < n; ++j) {
+      long double sum = 0.0L;
+      double magnitude = 0.0;
+      for (int p = 0; p < k; ++p) {
+        sum += static_cast<long double>(a(i, p)) * b(p, j);
+        magnitude += std::fabs(a(i, p) * b(p, j));
+      }
+      ref.value[static_cast<std::size_t>(i) * n + j] = sum;
+      ref.magnitude[static_cast<std::size_t>(i) * n + j] = magnitude;
+    }
+  }
+  return ref;
+}
+
+// |C - ref| <= factor * gamma(k) * |A||B| поэлементно
+std::string compare_product(const S21Matrix& c, const Reference& ref, int k,
+                            double factor) {
+  const int n = c.get_cols();
+  for (int i = 0; i < c.get_rows(); ++i) {
+    for (int j = 0; j < n; ++j) {
+      const std::size_t at = static_cast<std::size_t>(i) * n + j;
+      const double error = std::fabs(static_cast<double>(c(i, j) -
+                                                         ref.value[at]));
+      const double bound =
+          factor * gamma(k + 2) * ref.magnitude[at] + 1e-300;
+      if (!(error <= bound)) {
+        std::ostringstream out;
+        out << "element (" << i << ", " << j << "): error " << error
+            << " > bound " << bound;
+        return out.str();
+      }
+    }
+  }
+  return "";
+}
+
+// расстояние в единицах последнего разряда
+std::uint64_t ulp_distance(double x, double y) {
+  if (x == y) {
+    return 0;
+  }
+  auto ordered = [](double v) {
+    std::int64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits < 0 ? std::numeric_limits<std::int64_t>::min() - bits : bits;
+  };
+  const std::int64_t a = ordered(x);
+  const std::int64_t b = ordered(y);
+  return a > b ? static_cast<std::uint64_t>(a) - b
+               : static_cast<std::uint64_t>(b) - a;
+}
+
+std::string compare_ulp(const S21Matrix& x, const S21Matrix& y,
+                        std::uint64_t max_ulp) {
+  if (x.get_rows() != y.get_rows() || x.get_cols() != y.get_cols()) {
+    return "shape mismatch";
+  }
+  for (int i = 0; i < x.get_rows(); ++i) {
+    for (int j = 0; j < x.get_cols(); ++j) {
+      if (ulp_distance(x(i, j), y(i, j)) > max_ulp) {
+        std::ostringstream out;
+        out << "element (" << i << ", " << j << "): " << x(i, j) << " vs "
+            << y(i, j);
+        return out.str();
+      }
+    }
+  }
+  return "";
+}
+
+// Профили, включающие разные ветки ядер: последовательные и
+// параллельные, блоки, не кратные ширине векторов.
+std::vector<S21TuningProfile> kernel_profiles() {
+  S21TuningProfile sequential;
+  sequential.gemm_block = 9;
+  sequential.gemm_parallel_flops = std::numeric_limits<double>::infinity();
+  sequential.transpose_block = 7;
+  sequential.reduce_parallel_size = std::numeric_limits<std::size_t>::max();
+  sequential.lu_parallel_work = std::numeric_limits<double>::infinity();
+  S21TuningProfile parallel;
+  parallel.gemm_block = 16;
+  parallel.gemm_grain = 1;
+  parallel.gemm_parallel_flops = 0.0;
+  parallel.transpose_block = 3;
+  parallel.reduce_parallel_size = 0;
+  parallel.lu_parallel_work = 0.0;
+  return {S21Tuning::get(), sequential, parallel};
+}
+
+// возвращает исходный профиль по выходе из теста
+class ProfileGuard {
+ public:
+  ProfileGuard() : saved_(S21Tuning::get()) {}
+  ~ProfileGuard() { S21Tuning::set(saved_); }
+
+ private:
+  S21TuningProfile saved_;
+};
+
+// ошибка обратного хода LU: |b - A x| <= c * n * gamma(3n) * |A||x|
+std::string check_residual(const S21Matrix& a, const S21Matrix& x,
+                           const S21Matrix& b) {
+  const int n = a.get_rows();
+  for (int i = 0; i < n; ++i) {
+    for (int c = 0; c < b.get_cols(); ++c) {
+      long double residual = b(i, c);
+      double magnitude = std::fabs(b(i, c));
+      for (int p = 0; p < n; ++p) {
+        residual -= static_cast<long double>(a(i, p)) * x(p, c);
+        magnitude += std::fabs(a(i, p) * x(p, c));
+      }
+      const double bound = 4.0 * n * gamma(3 * n) * magnitude + 1e-300;
+      if (!(std::fabs(static_cast<double>(residual)) <= bound)) {
+        std::ostringstream out;
+        out << "residual at (" << i << ", " << c << ") exceeds " << bound;
+        return out.str();
+      }
+    }
+  }
+  return "";
+}
+
+// Прямое исключение с выбором ведущего элемента: определитель и
+// наименьший по модулю ведущий элемент.
+struct ReferenceLu {
+  long double determinant;
+  long double min_pivot;
+};
+
+ReferenceLu reference_lu(const S21Matrix& a) {
+  const int n = a.get_rows();
+  std::vector<long double> m(a.begin(), a.end());
+  ReferenceLu result{1.0L, std::numeric_limits<long double>::infinity()};
+  for (int k = 0; k < n; ++k) {
+    int pivot = k;
+    for (int i = k + 1; i < n; ++i) {
+      if (std::fabs(m[i * n + k]) > std::fabs(m[pivot * n + k])) {
+        pivot = i;
+      }
+    }
+    result.min_pivot = std::min(result.min_pivot, std::fabs(m[pivot * n + k]));
+    if (m[pivot * n + k] == 0.0L) {
+      result.determinant = 0.0L;
+      return result;
+    }
+    if (pivot != k) {
+      for (int j = 0; j < n; ++j) {
+        std::swap(m[k * n + j], m[pivot * n + j]);
+      }
+      result.determinant = -result.determinant;
+    }
+    result.determinant *= m[k * n + k];
+    for (int i = k + 1; i < n; ++i) {
+      const long double factor = m[i * n + k] / m[k * n + k];
+      for (int j = k; j < n; ++j) {
+        m[i * n + j] -= factor * m[k * n + j];
+      }
+    }
+  }
+  return result;
+}
+
+// LU вправе объявить матрицу вырожденной, только если и эталон
+// находит ведущий элемент ниже допуска n * ||A||_inf * eps (с запасом)
+std::string check_singular(const S21Matrix& a) {
+  const double tolerance = 4.0 * a.get_rows() * a.norm_inf() * kEps;
+  if (reference_lu(a).min_pivot <= tolerance) {
+    return "";
+  }
+  return "reported singular, reference pivots exceed tolerance";
+}
+}  // namespace
+
+TEST(test_differential, gemm) {
+  ProfileGuard guard;
+  for (const S21TuningProfile& profile : kernel_profiles()) {
+    S21Tuning::set(profile);
+    check_property(
+        [](const Case& c) {
+          const S21Matrix a = make_matrix(c.dims[0], c.dims[1], c.fill, c.seed);
+          const S21Matrix b =
+              make_matrix(c.dims[1], c.dims[2], c.fill, c.seed + 1);
+          return compare_product(a * b, reference_mul(a, b), c.dims[1], 2.0);
+        },
+        70);
+  }
+}
+
+TEST(test_differential, gemm_alpha_beta) {
+  check_property(
+      [](const Case& c) {
+        const S21Matrix a = make_matrix(c.dims[0], c.dims[1], c.fill, c.seed);
+        const S21Matrix b =
+            make_matrix(c.dims[1], c.dims[2], c.fill, c.seed + 1);
+        S21Matrix result =
+            make_matrix(c.dims[0], c.dims[2], Fill::kUniform, c.seed + 2);
+        Reference ref = reference_mul(a, b);
+        for (std::size_t at = 0; at < ref.value.size(); ++at) {
+          const double old = result.begin()[at];
+          ref.value[at] = -1.5L * ref.value[at] + 0.25L * old;
+          ref.magnitude[at] = 1.5 * ref.magnitude[at] + 0.25 * std::fabs(old);
+        }
+        S21Matrix::gemm(-1.5, a, b, 0.25, result);
+        return compare_product(result, ref, c.dims[1], 2.0);
+      },
+      50);
+}
+
+TEST(test_differential, elementwise_exact) {
+  // одна операция округления на элемент: результат обязан совпасть
+  check_property(
+      [](const Case& c) {
+        const S21Matrix a = make_matrix(c.dims[0], c.dims[1], c.fill, c.seed);
+        const S21Matrix b =
+            make_matrix(c.dims[0], c.dims[1], c.fill, c.seed + 1);
+        S21Matrix sum(c.dims[0], c.dims[1]);
+        S21Matrix scaled(c.dims[0], c.dims[1]);
+        S21Matrix transposed(c.dims[1], c.dims[0]);
+        for (int i = 0; i < c.dims[0]; ++i) {
+          for (int j = 0; j < c.dims[1]; ++j) {
+            sum(i, j) = a(i, j) + b(i, j);
+            scaled(i, j) = a(i, j) * 0.3;
+            transposed(j, i) = a(i, j);
+          }
+        }
+        std::string failure = compare_ulp(a + b, sum, 0);
+        if (failure.empty()) {
+          failure = compare_ulp(a * 0.3, scaled, 0);
+        }
+        if (failure.empty()) {
+          failure = compare_ulp(a.transpose(), transposed, 0);
+        }
+        return failure;
+      },
+      90);
+}
+
+TEST(test_differential, reductions) {
+  ProfileGuard guard;
+  for (const S21TuningProfile& profile : kernel_profiles()) {
+    S21Tuning::set(profile);
+    check_property(
+        [](const Case& c) {
+          const S21Matrix a = make_matrix(c.dims[0], c.dims[1], c.fill, c.seed);
+          const int count = c.dims[0] * c.dims[1];
+          long double sum = 0.0L;
+          long double squares = 0.0L;
+          double magnitude = 0.0;
+          double max_abs = 0.0;
+          for (double v : a) {
+            sum += v;
+            squares += static_cast<long double>(v) * v;
+            magnitude += std::fabs(v);
+            max_abs = std::max(max_abs, std::fabs(v));
+          }
+          std::ostringstream out;
+          if (!(std::fabs(a.sum() - static_cast<double>(sum)) <=
+                gamma(count) * magnitude)) {
+            out << "sum " << a.sum() << " vs " << static_cast<double>(sum);
+          }
+          const double norm = std::sqrt(static_cast<double>(squares));
+          if (!(std::fabs(a.norm_frobenius() - norm) <=
+                gamma(count + 4) * norm)) {
+            out << "frobenius " << a.norm_frobenius() << " vs " << norm;
+          }
+          if (a.norm_max() != max_abs) {
+            out << "max abs " << a.norm_max() << " vs " << max_abs;
+          }
+          const S21Matrix rows = a.row_sums();
+          const S21Matrix cols = a.col_sums();
+          for (int i = 0; i < c.dims[0]; ++i) {
+            long double row = 0.0L;
+            double row_magnitude = 0.0;
+            for (int j = 0; j < c.dims[1]; ++j) {
+              row += a(i, j);
+              row_magnitude += std::fabs(a(i, j));
+            }
+            if (!(std::fabs(rows(i, 0) - static_cast<double>(row)) <=
+                  gamma(c.dims[1]) * row_magnitude)) {
+              out << "row sum " << i;
+            }
+          }
+          for (int j = 0; j < c.dims[1]; ++j) {
+            long double col = 0.0L;
+            double col_magnitude = 0.0;
+            for (int i = 0; i < c.dims[0]; ++i) {
+              col += a(i, j);
+              col_magnitude += std::fabs(a(i, j));
+            }
+            if (!(std::fabs(cols(0, j) - static_cast<double>(col)) <=
+                  gamma(c.dims[0]) * col_magnitude)) {
+              out << "col sum " << j;
+            }
+          }
+          return out.str();
+        },
+        300);
+  }
+}
+
+TEST(test_differential, lu_solve_and_determinant) {
+  ProfileGuard guard;
+  for (const S21TuningProfile& profile : kernel_profiles()) {
+    S21Tuning::set(profile);
+    check_property(
+        [](const Case& c) {
+          const int n = c.dims[0];
+          const S21Matrix a = make_matrix(n, n, c.fill, c.seed);
+          const S21Matrix b = make_matrix(n, 2, Fill::kUniform, c.seed + 1);
+          S21Matrix x;
+          try {
+            x = a.lu_decompose().solve(b);
+          } catch (const std::exception&) {
+            return check_singular(a);
+          }
+          std::string failure = check_residual(a, x, b);
+          if (!failure.empty()) {
+            return failure;
+          }
+          // |det - ref| <= c * n^2 * gamma(3n) * prod ||a_i||_2 (Адамар)
+          double hadamard = 1.0;
+          for (int i = 0; i < n; ++i) {
+            double row = 0.0;
+            for (int j = 0; j < n; ++j) {
+              row += a(i, j) * a(i, j);
+            }
+            hadamard *= std::sqrt(row);
+          }
+          const double det = a.determinant();
+          const double ref = static_cast<double>(reference_lu(a).determinant);
+          const double bound = 8.0 * n * n * gamma(3 * n) * hadamard;
+          if (!(std::fabs(det - ref) <= bound + 1e-300)) {
+            std::ostringstream out;
+            out << "determinant " << det << " vs " << ref;
+            return out.str();
+          }
+          return std::string();
+        },
+        40);
+  }
+}
+
+TEST(test_differential, mixed_solver) {
+  check_property(
+      [](const Case& c) {
+        const int n = c.dims[0];
+        S21Matrix a = make_matrix(n, n, c.fill, c.seed);
+        const S21Matrix b = make_matrix(n, 1, Fill::kUniform, c.seed + 1);
+        S21MixedSolver solver(a);
+        try {
+          return check_residual(a, solver.solve(b), b);
+        } catch (const std::exception&) {
+          return check_singular(a);
+        }
+      },
+      60);
+}
+
+TEST(test_differential, structured_and_tiled) {
+  check_property(
+      [](const Case& c) {
+        const S21Matrix a = make_matrix(c.dims[0], c.dims[1], c.fill, c.seed);
+        const S21Matrix b =
+            make_matrix(c.dims[1], c.dims[2], c.fill, c.seed + 1);
+        // произведение в тайловом формате
+        const int tile = 1 + c.dims[2] % 8;
+        S21Matrix tiled =
+            S21TiledMatrix(a, tile).mul_matrix(S21TiledMatrix(b, tile))
+                .to_matrix();
+        std::string failure =
+            compare_product(tiled, reference_mul(a, b), c.dims[1], 2.0);
+        if (!failure.empty()) {
+          return "tiled: " + failure;
+        }
+        // верхний треугольник A * A^T
+        const S21Matrix gram = S21SymmetricMatrix::syrk(a).to_matrix();
+        return compare_product(gram, reference_mul(a, a.transpose()),
+                               c.dims[1], 2.0);
+      },
+      50);
+}
+
+TEST(test_differential, kronecker) {
+  check_property(
+      [](const Case& c) {
+        const int m = 1 + c.dims[0] % 9;
+        const int n = 1 + c.dims[1] % 9;
+        const S21Matrix a = make_matrix(m, n, c.fill, c.seed);
+        const S21Matrix b = make_matrix(c.dims[2] % 7 + 1, c.dims[0] % 5 + 1,
+                                        c.fill, c.seed + 1);
+        S21Matrix explicit_kron(m * b.get_rows(), n * b.get_cols());
+        for (int i = 0; i < explicit_kron.get_rows(); ++i) {
+          for (int j = 0; j < explicit_kron.get_cols(); ++j) {
+            explicit_kron(i, j) = a(i / b.get_rows(), j / b.get_cols()) *
+                                  b(i % b.get_rows(), j % b.get_cols());
+          }
+        }
+        std::string failure =
+            compare_ulp(S21KroneckerOperator::kron(a, b), explicit_kron, 0);
+        if (!failure.empty()) {
+          return "kron: " + failure;
+        }
+        const S21Matrix x =
+            make_matrix(explicit_kron.get_cols(), 2, Fill::kUniform, c.seed);
+        // vec-тождество суммирует по двум индексам: n + q слагаемых
+        return compare_product(S21KroneckerOperator(a, b).mul_matrix(x),
+                               reference_mul(explicit_kron, x),
+                               n * b.get_cols(), 4.0);
+      },
+      60);
+}
+
+TEST(test_differential, quantized_simd) {
+  // SIMD-ядра сравниваются с переносимыми: int8 побитово,
+  // bf16 - с точностью накопления во float
+  check_property(
+      [](const Case& c) {
+        const S21Matrix a = make_matrix(c.dims[0], c.dims[1], c.fill, c.seed);
+        const S21Matrix b =
+            make_matrix(c.dims[1], c.dims[2], c.fill, c.seed + 1);
+        const S21QuantizedMatrix qa(a);
+        const S21QuantizedMatrix qb(b, S21Operand::kRight);
+        const S21Bf16Matrix ha(a);
+        const S21Bf16Matrix hb(b, S21Operand::kRight);
+        S21QuantizedMatrix::set_simd_limit(S21SimdLevel::kPortable);
+        const S21Matrix int8_portable = qa.mul_matrix(qb);
+        const S21Matrix bf16_portable = ha.mul_matrix(hb);
+        S21QuantizedMatrix::set_simd_limit(S21SimdLevel::kAvx512);
+        std::string failure = compare_ulp(qa.mul_matrix(qb), int8_portable, 0);
+        if (!failure.empty()) {
+          return "int8: " + failure;
+        }
+        const Reference ref =
+            reference_mul(ha.to_matrix(), hb.to_matrix());
+        const S21Matrix bf16 = ha.mul_matrix(hb);
+        for (std::size_t at = 0; at < ref.magnitude.size(); ++at) {
+          const double bound = 2.0 * c.dims[1] *
+                               std::numeric_limits<float>::epsilon() *
+                               ref.magnitude[at];
+          if (!(std::fabs(bf16.begin()[at] - bf16_portable.begin()[at]) <=
+                bound + 1e-300)) {
+            return std::string("bf16 kernels disagree");
+          }
+        }
+        return std::string();
+      },
+      80);
+}
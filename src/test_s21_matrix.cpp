@@ -1,6 +1,32 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <thread>
+#include <vector>
+#if __has_include(<execution>)
+#include <execution>
+#endif
+
 #include <gtest/gtest.h>
 
+#include "s21_allocator.h"
+#include "s21_kronecker.h"
+#include "s21_low_rank.h"
 #include "s21_matrix_oop.h"
+#include "s21_mixed_solver.h"
+#include "s21_out_of_core.h"
+#include "s21_quantized_matrix.h"
+#include "s21_shared_matrix.h"
+#include "s21_structured_matrix.h"
+#include "s21_tiled_matrix.h"
+#include "s21_tuning.h"
+#include "s21_updatable_matrix.h"
 
 TEST(test_class, default_constructor) {
   S21Matrix m;
@@ -751,6 +777,1568 @@ TEST(test_functional, inverse_4x4_zero_determinant) {
   EXPECT_ANY_THROW({ S21Matrix inv = m.inverse_matrix(); });
 }
 
+TEST(test_functional, multiply_chain) {
+  S21Matrix a(10, 30);
+  S21Matrix b(30, 5);
+  S21Matrix c(5, 60);
+  S21Matrix d(60, 2);
+  for (int i = 0; i < 30; ++i) {
+    for (int j = 0; j < 5; ++j) {
+      b(i, j) = i - j;
+    }
+  }
+  for (int i = 0; i < 10; ++i) {
+    for (int j = 0; j < 30; ++j) {
+      a(i, j) = (i * j) % 7;
+    }
+  }
+  for (int i = 0; i < 5; ++i) {
+    for (int j = 0; j < 60; ++j) {
+      c(i, j) = i + j % 3;
+    }
+  }
+  for (int i = 0; i < 60; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      d(i, j) = j - i % 5;
+    }
+  }
+  S21Matrix result = S21Matrix::multiply_chain({&a, &b, &c, &d});
+  EXPECT_TRUE(result == a * b * c * d);
+  EXPECT_EQ(result.get_rows(), 10);
+  EXPECT_EQ(result.get_cols(), 2);
+}
+
+TEST(test_functional, multiply_chain_single) {
+  S21Matrix a(2, 3);
+  a(1, 2) = 5.;
+  EXPECT_TRUE(S21Matrix::multiply_chain({&a}) == a);
+}
+
+TEST(test_functional, multiply_chain_exception) {
+  S21Matrix a(2, 3);
+  S21Matrix b(2, 3);
+  EXPECT_ANY_THROW(S21Matrix::multiply_chain({&a, &b}));
+  EXPECT_ANY_THROW(S21Matrix::multiply_chain({&a, nullptr}));
+  EXPECT_ANY_THROW(S21Matrix::multiply_chain({}));
+}
+
+TEST(test_functional, lu_decompose) {
+  S21Matrix m(3, 3);
+  m(0, 0) = 2.;
+  m(0, 1) = 5.;
+  m(0, 2) = 7.;
+  m(1, 0) = 6.;
+  m(1, 1) = 3.;
+  m(1, 2) = 4.;
+  m(2, 0) = 5.;
+  m(2, 1) = -2.;
+  m(2, 2) = -3.;
+  S21LuFactorization lu = m.lu_decompose();
+  EXPECT_FALSE(lu.singular);
+  EXPECT_NEAR(lu.determinant(), -1., 1e-9);
+  S21Matrix identity = m * lu.inverse();
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      EXPECT_NEAR(identity(i, j), i == j ? 1. : 0., 1e-9);
+    }
+  }
+}
+
+TEST(test_functional, lu_decompose_singular) {
+  S21Matrix m(3, 3);
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      m(i, j) = i * 3 + j + 1;
+    }
+  }
+  S21LuFactorization lu = m.lu_decompose();
+  EXPECT_TRUE(lu.singular);
+  EXPECT_EQ(lu.determinant(), 0.);
+  EXPECT_ANY_THROW(lu.inverse());
+  EXPECT_ANY_THROW(S21Matrix(2, 3).lu_decompose());
+  // малый, но ненулевой определитель: порог только у явного LU
+  S21Matrix tiny(5, 5);
+  for (int i = 0; i < 5; ++i) {
+    tiny(i, i) = 1.;
+  }
+  tiny(4, 4) = 1e-20;
+  EXPECT_TRUE(tiny.lu_decompose().singular);
+  EXPECT_FALSE(tiny.lu_decompose(0.0).singular);
+  EXPECT_DOUBLE_EQ(tiny.determinant(), 1e-20);
+  EXPECT_DOUBLE_EQ(tiny.inverse_matrix()(4, 4), 1e20);
+}
+
+TEST(test_functional, singularity_verdict_shared) {
+  // ранг 3: LU даёт точно нулевой ведущий элемент, а разложение по
+  // минорам - остаток округления; обратная должна следовать определителю
+  const int values[4][4] = {
+      {8, 5, 1, -4}, {-9, 5, 2, -7}, {-3, 1, 1, -9}, {2, 9, 2, -2}};
+  S21Matrix m(4, 4);
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      m(i, j) = values[i][j] / 10.;
+    }
+  }
+  EXPECT_TRUE(m.lu_decompose(0.0).singular);
+  const double det = m.determinant();
+  if (det == 0.) {
+    EXPECT_THROW(m.inverse_matrix(), std::invalid_argument);
+    EXPECT_THROW(m.calc_complements(), std::invalid_argument);
+  } else {
+    EXPECT_NO_THROW(m.inverse_matrix());
+    EXPECT_NO_THROW(m.calc_complements());
+  }
+}
+
+static S21Matrix make_test_matrix(int n) {
+  S21Matrix m(n, n);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      m(i, j) = (i == j) ? n + 1. : 1. / (i + 2 * j + 1);
+    }
+  }
+  return m;
+}
+
+static void expect_matrix_near(const S21Matrix& a, const S21Matrix& b,
+                               double eps) {
+  ASSERT_EQ(a.get_rows(), b.get_rows());
+  ASSERT_EQ(a.get_cols(), b.get_cols());
+  for (int i = 0; i < a.get_rows(); ++i) {
+    for (int j = 0; j < a.get_cols(); ++j) {
+      EXPECT_NEAR(a(i, j), b(i, j), eps);
+    }
+  }
+}
+
+TEST(test_update, rank1_update) {
+  S21UpdatableMatrix m(make_test_matrix(5));
+  S21Matrix u(5, 1);
+  S21Matrix v(5, 1);
+  for (int i = 0; i < 5; ++i) {
+    u(i, 0) = i + 1.;
+    v(i, 0) = 0.5 - i % 2;
+  }
+  m.rank1_update(u, v);
+  S21Matrix expected = make_test_matrix(5) + u * S21Matrix(v).transpose();
+  S21Matrix matrix = m.get_matrix();
+  expect_matrix_near(matrix, expected, 1e-12);
+  S21LuFactorization lu = expected.lu_decompose();
+  S21Matrix inverse = m.get_inverse();
+  S21Matrix expected_inverse = lu.inverse();
+  expect_matrix_near(inverse, expected_inverse, 1e-9);
+  EXPECT_NEAR(m.determinant(), lu.determinant(),
+              1e-9 * std::fabs(lu.determinant()));
+  EXPECT_EQ(m.get_refactorizations(), 1);
+}
+
+TEST(test_update, rank_k_update) {
+  S21UpdatableMatrix m(make_test_matrix(6));
+  S21Matrix u(6, 2);
+  S21Matrix v(6, 2);
+  for (int i = 0; i < 6; ++i) {
+    u(i, 0) = 1.;
+    u(i, 1) = i * 0.25;
+    v(i, 0) = (i % 3) - 1.;
+    v(i, 1) = 0.1 * i;
+  }
+  m.rank_k_update(u, v);
+  m.rank_k_update(u, v);
+  S21Matrix expected = make_test_matrix(6) + u * S21Matrix(v).transpose() * 2.;
+  S21LuFactorization lu = expected.lu_decompose();
+  S21Matrix inverse = m.get_inverse();
+  S21Matrix expected_inverse = lu.inverse();
+  expect_matrix_near(inverse, expected_inverse, 1e-9);
+  EXPECT_NEAR(m.determinant(), lu.determinant(),
+              1e-9 * std::fabs(lu.determinant()));
+}
+
+TEST(test_update, refactorize_on_drift) {
+  S21UpdatableMatrix m(make_test_matrix(4), 0.);
+  S21Matrix u(4, 1);
+  S21Matrix v(4, 1);
+  u(0, 0) = 1.;
+  v(3, 0) = 2.;
+  m.rank1_update(u, v);
+  EXPECT_EQ(m.get_refactorizations(), 2);
+}
+
+TEST(test_update, update_exception) {
+  S21Matrix identity(2, 2);
+  identity(0, 0) = 1.;
+  identity(1, 1) = 1.;
+  S21UpdatableMatrix m(identity);
+  S21Matrix u(2, 1);
+  S21Matrix v(2, 1);
+  u(0, 0) = 1.;
+  v(0, 0) = -1.;  // I - e0 * e0^T вырождена
+  EXPECT_ANY_THROW(m.rank1_update(u, v));
+  EXPECT_DOUBLE_EQ(m.determinant(), 1.);
+  EXPECT_ANY_THROW(m.rank1_update(S21Matrix(3, 1), v));
+  EXPECT_ANY_THROW(m.rank1_update(S21Matrix(2, 2), S21Matrix(2, 2)));
+  EXPECT_ANY_THROW(S21UpdatableMatrix(S21Matrix(2, 2)));
+}
+
+TEST(test_cache, version_counter) {
+  S21Matrix m(2, 2);
+  unsigned long long version = m.get_version();
+  m(0, 0) = 1.;
+  EXPECT_GT(m.get_version(), version);
+  version = m.get_version();
+  m[1][1] = 2.;
+  EXPECT_GT(m.get_version(), version);
+  version = m.get_version();
+  m.set_rows(3);
+  EXPECT_GT(m.get_version(), version);
+  version = m.get_version();
+  m *= 2.;
+  EXPECT_GT(m.get_version(), version);
+  version = m.get_version();
+  EXPECT_FALSE(m == S21Matrix(2, 2));
+  m.get_rows();
+  EXPECT_EQ(m.get_version(), version);
+}
+
+TEST(test_cache, cached_determinant_inverse) {
+  S21Matrix m = make_test_matrix(6);
+  m.set_caching(true);
+  EXPECT_TRUE(m.get_caching());
+  double det = m.determinant();
+  S21Matrix inv = m.inverse_matrix();
+  S21Matrix comp = m.calc_complements();
+  EXPECT_EQ(m.determinant(), det);
+  EXPECT_TRUE(m.inverse_matrix() == inv);
+  EXPECT_TRUE(m.calc_complements() == comp);
+  S21Matrix identity = m * inv;
+  for (int i = 0; i < 6; ++i) {
+    for (int j = 0; j < 6; ++j) {
+      EXPECT_NEAR(identity(i, j), i == j ? 1. : 0., 1e-12);
+      EXPECT_NEAR(comp(i, j), det * inv(j, i), 1e-9 * std::fabs(det));
+    }
+  }
+  m(0, 0) += 1.;
+  EXPECT_NE(m.determinant(), det);
+  S21Matrix uncached = m;
+  uncached.set_caching(false);
+  EXPECT_DOUBLE_EQ(m.determinant(), uncached.determinant());
+}
+
+TEST(test_cache, cache_invalidation) {
+  S21Matrix m(2, 2);
+  m.set_caching(true);
+  m(0, 0) = 1.;
+  m(1, 1) = 1.;
+  EXPECT_DOUBLE_EQ(m.determinant(), 1.);
+  m[1][1] = 3.;
+  EXPECT_DOUBLE_EQ(m.determinant(), 3.);
+  m.mul_number(2.);
+  EXPECT_DOUBLE_EQ(m.determinant(), 12.);
+  m.set_cols(3);
+  EXPECT_ANY_THROW(m.determinant());
+}
+
+TEST(test_cache, concurrent_const_readers) {
+  S21Matrix m = make_test_matrix(6);
+  m.set_caching(true);
+  const S21Matrix& shared = m;
+  const double det = S21Matrix(m).determinant();
+  const unsigned long long version = m.get_version();
+  std::vector<std::thread> readers;
+  std::vector<int> mismatches(4, 0);
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([&shared, &mismatches, det, t]() {
+      for (int k = 0; k < 50; ++k) {
+        double sum = 0.;
+        for (int i = 0; i < shared.get_rows(); ++i) {
+          sum += shared(i, i) + shared[i][0] + shared.row_data(i)[1];
+        }
+        if (shared.determinant() != det || !std::isfinite(sum)) {
+          ++mismatches[t];
+        }
+      }
+    });
+  }
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(mismatches, std::vector<int>(4, 0));
+  EXPECT_EQ(m.get_version(), version);
+}
+
+TEST(test_functional, determinant_lu_5x5) {
+  S21Matrix m(5, 5);
+  for (int i = 0; i < 5; ++i) {
+    m(i, i) = i + 1.;
+    m(0, i) = 1.;
+  }
+  EXPECT_NEAR(m.determinant(), 120., 1e-9);
+}
+
+TEST(test_functional, pow) {
+  S21Matrix m(3, 3);
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      m(i, j) = (i + 2 * j) % 3 - 1.;
+    }
+  }
+  S21Matrix expected(m);
+  for (int k = 1; k < 11; ++k) {
+    EXPECT_TRUE(m.pow(k) == expected);
+    expected *= m;
+  }
+  S21Matrix identity = m.pow(0);
+  EXPECT_DOUBLE_EQ(identity(0, 0), 1.);
+  EXPECT_DOUBLE_EQ(identity(0, 1), 0.);
+  EXPECT_ANY_THROW(S21Matrix(2, 3).pow(2));
+}
+
+TEST(test_functional, pow_negative) {
+  S21Matrix m(2, 2);
+  m(0, 0) = 4.;
+  m(0, 1) = 7.;
+  m(1, 0) = 2.;
+  m(1, 1) = 6.;
+  S21Matrix inv = m.pow(-2);
+  S21Matrix identity = inv * m * m;
+  EXPECT_NEAR(identity(0, 0), 1., 1e-12);
+  EXPECT_NEAR(identity(0, 1), 0., 1e-12);
+  EXPECT_NEAR(identity(1, 0), 0., 1e-12);
+  EXPECT_NEAR(identity(1, 1), 1., 1e-12);
+  // перестановка: P^-1 = P, степень INT_MIN чётная
+  S21Matrix swap(2, 2);
+  swap(0, 1) = 1.;
+  swap(1, 0) = 1.;
+  S21Matrix even = swap.pow(std::numeric_limits<int>::min());
+  EXPECT_EQ(even(0, 0), 1.);
+  EXPECT_EQ(even(0, 1), 0.);
+  EXPECT_TRUE(swap.pow(std::numeric_limits<int>::max()) == swap);
+}
+
+TEST(test_functional, mul_matrix_large) {
+  S21Matrix a(70, 90);
+  S21Matrix b(90, 80);
+  for (int i = 0; i < 90; ++i) {
+    for (int j = 0; j < 70; ++j) {
+      a(j, i) = (i * j) % 5 - 2.;
+    }
+    for (int j = 0; j < 80; ++j) {
+      b(i, j) = (i + j) % 7 - 3.;
+    }
+  }
+  S21Matrix c = a * b;
+  for (int i = 0; i < 70; i += 13) {
+    for (int j = 0; j < 80; j += 11) {
+      double sum = 0.;
+      for (int k = 0; k < 90; ++k) {
+        sum += a(i, k) * b(k, j);
+      }
+      EXPECT_DOUBLE_EQ(c(i, j), sum);
+    }
+  }
+}
+
+TEST(test_functional, expm) {
+  S21Matrix zero(3, 3);
+  S21Matrix e = zero.expm();
+  EXPECT_DOUBLE_EQ(e(0, 0), 1.);
+  EXPECT_DOUBLE_EQ(e(1, 2), 0.);
+  S21Matrix nilpotent(2, 2);
+  nilpotent(0, 1) = 3.;
+  e = nilpotent.expm();
+  EXPECT_NEAR(e(0, 0), 1., 1e-14);
+  EXPECT_NEAR(e(0, 1), 3., 1e-14);
+  EXPECT_NEAR(e(1, 0), 0., 1e-14);
+  S21Matrix rotation(2, 2);
+  rotation(0, 1) = -2.;
+  rotation(1, 0) = 2.;
+  e = rotation.expm();
+  EXPECT_NEAR(e(0, 0), std::cos(2.), 1e-13);
+  EXPECT_NEAR(e(0, 1), -std::sin(2.), 1e-13);
+  EXPECT_NEAR(e(1, 0), std::sin(2.), 1e-13);
+  S21Matrix diag(2, 2);
+  diag(0, 0) = 10.;
+  diag(1, 1) = -1.;
+  e = diag.expm();
+  EXPECT_NEAR(e(0, 0) / std::exp(10.), 1., 1e-12);
+  EXPECT_NEAR(e(1, 1), std::exp(-1.), 1e-14);
+  EXPECT_ANY_THROW(S21Matrix(2, 3).expm());
+  diag(0, 1) = std::numeric_limits<double>::infinity();
+  EXPECT_THROW(diag.expm(), std::invalid_argument);
+  diag(0, 1) = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_THROW(diag.expm(), std::invalid_argument);
+}
+
+TEST(test_const, const_access) {
+  S21Matrix m(2, 2);
+  m(0, 1) = 2.;
+  m(1, 0) = 3.;
+  m(1, 1) = 1.;
+  const S21Matrix& c = m;
+  EXPECT_EQ(c(0, 1), 2.);
+  EXPECT_EQ(c[1][0], 3.);
+  EXPECT_ANY_THROW(c(2, 0));
+  EXPECT_ANY_THROW(c[-1]);
+  unsigned long long version = c.get_version();
+  EXPECT_DOUBLE_EQ(c.determinant(), -6.);
+  EXPECT_DOUBLE_EQ(c.transpose()(0, 1), 3.);
+  EXPECT_DOUBLE_EQ(c.inverse_matrix()(0, 1), 2. / 6.);
+  EXPECT_DOUBLE_EQ(c.calc_complements()(0, 1), -3.);
+  EXPECT_EQ(c.get_version(), version);
+}
+
+// Многопоточный тест для запуска под ThreadSanitizer (make tsan).
+TEST(test_const, concurrent_readers) {
+  for (bool caching : {false, true}) {
+    S21Matrix shared = make_test_matrix(6);
+    shared.set_caching(caching);
+    const S21Matrix& reader = shared;
+    S21Matrix reference = make_test_matrix(6);
+    const double det = reference.determinant();
+    const S21Matrix inv = reference.inverse_matrix();
+    const S21Matrix comp = reference.calc_complements();
+    std::vector<std::thread> threads;
+    std::vector<int> mismatches(8, 0);
+    for (int t = 0; t < 8; ++t) {
+      threads.emplace_back([&reader, &mismatches, &det, &inv, &comp, t]() {
+        for (int iter = 0; iter < 50; ++iter) {
+          if (reader.determinant() != det) ++mismatches[t];
+          if (!(reader.inverse_matrix() == inv)) ++mismatches[t];
+          if (!(reader.calc_complements() == comp)) ++mismatches[t];
+          if (reader.transpose()(1, 2) != reader(2, 1)) ++mismatches[t];
+          if (!(reader * reader == reader.pow(2))) ++mismatches[t];
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (int t = 0; t < 8; ++t) {
+      EXPECT_EQ(mismatches[t], 0);
+    }
+  }
+}
+
+TEST(test_unchecked, raw_access) {
+  S21Matrix m(3, 4);
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      m.at_unchecked(i, j) = i * 4 + j;
+    }
+  }
+  const S21Matrix& c = m;
+  const double* data = c.data();
+  for (int k = 0; k < 12; ++k) {
+    EXPECT_EQ(data[k], k);
+  }
+  EXPECT_EQ(c.row_data(2)[1], 9.);
+  EXPECT_EQ(c.at_unchecked(1, 3), 7.);
+  EXPECT_EQ(c[2], c.row_data(2));
+  unsigned long long version = m.get_version();
+  m.data()[0] = -1.;
+  EXPECT_GT(m.get_version(), version);
+  EXPECT_EQ(m(0, 0), -1.);
+}
+
+TEST(test_unchecked, status_arithmetic) {
+  S21Matrix a(2, 2);
+  S21Matrix b(2, 3);
+  a(0, 0) = 1.;
+  a(1, 1) = 2.;
+  EXPECT_EQ(a.try_sum_matrix(b), S21Status::kSizeMismatch);
+  EXPECT_EQ(a.try_sub_matrix(b), S21Status::kSizeMismatch);
+  EXPECT_EQ(b.try_mul_matrix(a), S21Status::kSizeMismatch);
+  EXPECT_EQ(a.try_sum_matrix(a), S21Status::kOk);
+  EXPECT_EQ(a(1, 1), 4.);
+  EXPECT_EQ(a.try_sub_matrix(S21Matrix(2, 2)), S21Status::kOk);
+  EXPECT_EQ(a.try_mul_matrix(b), S21Status::kOk);
+  EXPECT_EQ(a.get_cols(), 3);
+}
+
+TEST(test_unchecked, status_results) {
+  S21Matrix m(2, 2);
+  m(0, 0) = 4.;
+  m(0, 1) = 7.;
+  m(1, 0) = 2.;
+  m(1, 1) = 6.;
+  S21Result<double> det = m.try_determinant();
+  ASSERT_TRUE(det.has_value());
+  EXPECT_DOUBLE_EQ(*det, 10.);
+  S21Result<S21Matrix> inv = m.try_inverse_matrix();
+  ASSERT_TRUE(inv);
+  EXPECT_FLOAT_EQ(inv.value()(0, 0), 0.6);
+  EXPECT_EQ(S21Matrix(2, 3).try_determinant().error(), S21Status::kNotSquare);
+  S21Result<S21Matrix> singular = S21Matrix(2, 2).try_inverse_matrix();
+  EXPECT_FALSE(singular.has_value());
+  EXPECT_EQ(singular.error(), S21Status::kSingular);
+  EXPECT_ANY_THROW(singular.value());
+  // почти вырожденная матрица: статус или результат, но не terminate
+  const int values[4][4] = {
+      {8, 5, 1, -4}, {-9, 5, 2, -7}, {-3, 1, 1, -9}, {2, 9, 2, -2}};
+  S21Matrix probe(4, 4);
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      probe(i, j) = values[i][j] / 10.;
+    }
+  }
+  S21Result<S21Matrix> probe_inv = probe.try_inverse_matrix();
+  EXPECT_TRUE(probe_inv.has_value() ||
+              probe_inv.error() == S21Status::kSingular);
+  EXPECT_TRUE(probe.try_determinant().has_value());
+}
+
+TEST(test_iterator, element_iterators) {
+  S21Matrix m(3, 4);
+  std::iota(m.begin(), m.end(), 0.);
+  EXPECT_EQ(m(2, 3), 11.);
+  EXPECT_EQ(std::distance(m.begin(), m.end()), 12);
+  const S21Matrix& c = m;
+  EXPECT_DOUBLE_EQ(std::accumulate(c.begin(), c.end(), 0.), 66.);
+  EXPECT_DOUBLE_EQ(std::accumulate(c.row_begin(1), c.row_end(1), 0.), 22.);
+  std::transform(m.row_begin(0), m.row_end(0), m.row_begin(0),
+                 [](double x) { return -x; });
+  EXPECT_EQ(m(0, 3), -3.);
+  EXPECT_EQ(*std::max_element(c.cbegin(), c.cend()), 11.);
+}
+
+TEST(test_iterator, column_iterators) {
+  S21Matrix m(3, 4);
+  std::iota(m.begin(), m.end(), 0.);
+  const S21Matrix& c = m;
+  EXPECT_EQ(std::distance(c.col_begin(1), c.col_end(1)), 3);
+  EXPECT_DOUBLE_EQ(std::accumulate(c.col_begin(1), c.col_end(1), 0.), 15.);
+  std::fill(m.col_begin(3), m.col_end(3), 0.);
+  EXPECT_EQ(m(0, 3), 0.);
+  EXPECT_EQ(m(2, 3), 0.);
+  EXPECT_EQ(m(2, 2), 10.);
+  S21Matrix::const_column_iterator it = m.col_begin(2);
+  EXPECT_EQ(it[2], 10.);
+  EXPECT_EQ(*(it + 1), 6.);
+  EXPECT_TRUE(it < c.col_end(2));
+  std::reverse(m.col_begin(0), m.col_end(0));
+  EXPECT_EQ(m(0, 0), 8.);
+  EXPECT_EQ(m(2, 0), 0.);
+  static_assert(
+      std::is_same_v<std::iterator_traits<
+                         S21Matrix::column_iterator>::iterator_category,
+                     std::random_access_iterator_tag>);
+}
+
+#ifdef __cpp_lib_parallel_algorithm
+TEST(test_iterator, parallel_algorithms) {
+  S21Matrix m(300, 200);
+  std::fill(std::execution::par_unseq, m.begin(), m.end(), 1.5);
+  std::for_each(std::execution::par_unseq, m.begin(), m.end(),
+                [](double& x) { x *= 2.; });
+  const S21Matrix& c = m;
+  EXPECT_DOUBLE_EQ(std::reduce(std::execution::par, c.begin(), c.end()),
+                   300. * 200. * 3.);
+  EXPECT_DOUBLE_EQ(
+      std::reduce(std::execution::par, c.col_begin(5), c.col_end(5)), 900.);
+}
+#endif
+
+TEST(test_reduction, small_reductions) {
+  S21Matrix m(2, 3);
+  m(0, 0) = 1.;
+  m(0, 1) = -4.;
+  m(0, 2) = 2.;
+  m(1, 0) = 3.;
+  m(1, 1) = 0.5;
+  m(1, 2) = -1.;
+  EXPECT_DOUBLE_EQ(m.sum(), 1.5);
+  EXPECT_DOUBLE_EQ(m.norm_1(), 4.5);
+  EXPECT_DOUBLE_EQ(m.norm_inf(), 7.);
+  EXPECT_DOUBLE_EQ(m.norm_max(), 4.);
+  EXPECT_DOUBLE_EQ(m.norm_frobenius(), std::sqrt(31.25));
+  EXPECT_DOUBLE_EQ(m.min(), -4.);
+  EXPECT_DOUBLE_EQ(m.max(), 3.);
+  EXPECT_EQ(m.argmax(), std::make_pair(1, 0));
+  S21Matrix rows = m.row_sums();
+  EXPECT_DOUBLE_EQ(rows(0, 0), -1.);
+  EXPECT_DOUBLE_EQ(rows(1, 0), 2.5);
+  S21Matrix cols = m.col_sums();
+  EXPECT_DOUBLE_EQ(cols(0, 0), 4.);
+  EXPECT_DOUBLE_EQ(cols(0, 1), -3.5);
+  EXPECT_DOUBLE_EQ(cols(0, 2), 1.);
+  EXPECT_ANY_THROW(m.trace());
+  EXPECT_DOUBLE_EQ(make_test_matrix(3).trace(), 12.);
+}
+
+TEST(test_reduction, empty_matrix) {
+  S21Matrix m;
+  EXPECT_EQ(m.sum(), 0.);
+  EXPECT_EQ(m.norm_frobenius(), 0.);
+  EXPECT_EQ(m.norm_1(), 0.);
+  EXPECT_ANY_THROW(m.min());
+  EXPECT_ANY_THROW(m.max());
+  EXPECT_ANY_THROW(m.argmax());
+}
+
+TEST(test_reduction, large_reductions) {
+  const int rows = 1000;
+  const int cols = 700;
+  S21Matrix m(rows, cols);
+  std::fill(m.begin(), m.end(), 0.1);
+  m(417, 33) = 5.;
+  const double total = 0.1 * (rows * cols - 1) + 5.;
+  EXPECT_NEAR(m.sum(), total, 1e-9);
+  EXPECT_NEAR(m.norm_frobenius(),
+              std::sqrt(0.01 * (rows * cols - 1) + 25.), 1e-9);
+  EXPECT_DOUBLE_EQ(m.norm_max(), 5.);
+  EXPECT_NEAR(m.norm_1(), 0.1 * (rows - 1) + 5., 1e-11);
+  EXPECT_NEAR(m.norm_inf(), 0.1 * (cols - 1) + 5., 1e-11);
+  EXPECT_EQ(m.argmax(), std::make_pair(417, 33));
+  S21Matrix row_sums = m.row_sums();
+  S21Matrix col_sums = m.col_sums();
+  EXPECT_NEAR(row_sums(999, 0), 0.1 * cols, 1e-11);
+  EXPECT_NEAR(col_sums(0, 699), 0.1 * rows, 1e-11);
+  EXPECT_NEAR(col_sums(0, 33), 0.1 * (rows - 1) + 5., 1e-11);
+}
+
+TEST(test_reduction, nan_propagation) {
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  S21Matrix small(2, 3);
+  small(0, 1) = nan;
+  small(1, 2) = 7.;
+  EXPECT_TRUE(std::isnan(small.norm_max()));
+  EXPECT_TRUE(std::isnan(small.norm_1()));
+  EXPECT_TRUE(std::isnan(small.norm_inf()));
+  EXPECT_TRUE(std::isnan(small.min()));
+  EXPECT_TRUE(std::isnan(small.max()));
+  EXPECT_EQ(small.argmax(), std::make_pair(0, 1));
+  // NaN в первом куске параллельного прохода, максимум - в последнем
+  S21Matrix large(1000, 700);
+  std::fill(large.begin(), large.end(), 0.1);
+  large(2, 5) = nan;
+  large(999, 699) = 9.;
+  EXPECT_TRUE(std::isnan(large.norm_max()));
+  EXPECT_TRUE(std::isnan(large.norm_frobenius()));
+  EXPECT_TRUE(std::isnan(large.min()));
+  EXPECT_TRUE(std::isnan(large.max()));
+  EXPECT_EQ(large.argmax(), std::make_pair(2, 5));
+}
+
+static std::string temp_path(const std::string& name) {
+  return "/tmp/s21_matrix_test_" + std::to_string(::getpid()) + "_" + name +
+         ".bin";
+}
+
+TEST(test_out_of_core, tiled_file_roundtrip) {
+  S21Matrix m(13, 7);
+  std::iota(m.begin(), m.end(), -20.);
+  const std::string path = temp_path("roundtrip");
+  S21TiledFile::write(path, m, 4);
+  {
+    S21TiledFile file(path);
+    EXPECT_EQ(file.get_rows(), 13);
+    EXPECT_EQ(file.get_cols(), 7);
+    EXPECT_EQ(file.get_tile_rows(), 4);
+    EXPECT_EQ(file.get_tile_cols(), 2);
+    S21Matrix corner = file.read_tile(3, 1);
+    EXPECT_EQ(corner.get_rows(), 1);
+    EXPECT_EQ(corner.get_cols(), 3);
+    EXPECT_EQ(corner(0, 2), m(12, 6));
+    EXPECT_ANY_THROW(file.read_tile(4, 0));
+  }
+  EXPECT_TRUE(S21TiledFile::read(path) == m);
+  std::remove(path.c_str());
+  EXPECT_ANY_THROW(S21TiledFile(temp_path("missing")));
+  // размеры в заголовке, не помещающиеся в int, отвергаются
+  const std::string huge_path = temp_path("huge");
+  const std::int64_t dims[3] = {std::int64_t{1} << 32, 7, 4};
+  std::FILE* huge = std::fopen(huge_path.c_str(), "wb");
+  std::fwrite("S21TILE1", 1, 8, huge);
+  std::fwrite(dims, sizeof(dims), 1, huge);
+  std::fclose(huge);
+  EXPECT_THROW(S21TiledFile file(huge_path), std::runtime_error);
+  std::remove(huge_path.c_str());
+}
+
+TEST(test_out_of_core, multiply) {
+  S21Matrix a(37, 23);
+  S21Matrix b(23, 29);
+  for (int i = 0; i < 37; ++i) {
+    for (int j = 0; j < 23; ++j) {
+      a(i, j) = (i * 3 + j) % 11 - 5.;
+    }
+  }
+  for (int i = 0; i < 23; ++i) {
+    for (int j = 0; j < 29; ++j) {
+      b(i, j) = (i + j * 7) % 5 - 2.;
+    }
+  }
+  const std::size_t budget = 7 * 8 * 8 * sizeof(double);
+  const int tile = S21TiledFile::tile_for_budget(budget);
+  EXPECT_EQ(tile, 8);
+  const std::string a_path = temp_path("a");
+  const std::string b_path = temp_path("b");
+  const std::string c_path = temp_path("c");
+  S21TiledFile::write(a_path, a, tile);
+  S21TiledFile::write(b_path, b, tile);
+  S21OutOfCore::multiply(a_path, b_path, c_path, budget);
+  EXPECT_TRUE(S21TiledFile::read(c_path) == a * b);
+  S21OutOfCore::multiply(a_path, b_path, c_path, 100 * budget);
+  EXPECT_TRUE(S21TiledFile::read(c_path) == a * b);
+  EXPECT_ANY_THROW(S21OutOfCore::multiply(a_path, b_path, c_path, budget / 2));
+  EXPECT_ANY_THROW(S21OutOfCore::multiply(a_path, a_path, c_path, budget));
+  // выход поверх входа отвергается и вход остаётся целым
+  const std::string a_alias = "/tmp/./" + a_path.substr(5);
+  EXPECT_THROW(S21OutOfCore::multiply(a_path, b_path, a_alias, budget),
+               std::invalid_argument);
+  EXPECT_THROW(S21OutOfCore::multiply(a_path, b_path, b_path, budget),
+               std::invalid_argument);
+  EXPECT_TRUE(S21TiledFile::read(a_path) == a);
+  EXPECT_TRUE(S21TiledFile::read(b_path) == b);
+  std::remove(a_path.c_str());
+  std::remove(b_path.c_str());
+  std::remove(c_path.c_str());
+}
+
+TEST(test_tiled, conversion_and_access) {
+  S21Matrix m(11, 6);
+  std::iota(m.begin(), m.end(), 1.);
+  for (S21Layout layout : {S21Layout::kBlocked, S21Layout::kMorton}) {
+    S21TiledMatrix tiled(m, 4, layout);
+    EXPECT_EQ(tiled.get_rows(), 11);
+    EXPECT_EQ(tiled.get_cols(), 6);
+    EXPECT_EQ(tiled.get_layout(), layout);
+    EXPECT_EQ(tiled(10, 5), m(10, 5));
+    EXPECT_EQ(tiled(3, 4), m(3, 4));
+    tiled(7, 2) = -1.;
+    EXPECT_EQ(tiled.at_unchecked(7, 2), -1.);
+    EXPECT_ANY_THROW(tiled(11, 0));
+    tiled(7, 2) = m(7, 2);
+    EXPECT_TRUE(tiled.to_matrix() == m);
+  }
+  EXPECT_ANY_THROW(S21TiledMatrix(m, 0));
+  EXPECT_ANY_THROW(S21TiledMatrix(0, 3));
+}
+
+TEST(test_tiled, mul_and_transpose) {
+  S21Matrix a(19, 13);
+  S21Matrix b(13, 22);
+  for (int i = 0; i < 13; ++i) {
+    for (int j = 0; j < 19; ++j) {
+      a(j, i) = (i * 5 + j) % 9 - 4.;
+    }
+    for (int j = 0; j < 22; ++j) {
+      b(i, j) = (i + 3 * j) % 7 - 3.;
+    }
+  }
+  for (S21Layout layout : {S21Layout::kBlocked, S21Layout::kMorton}) {
+    S21TiledMatrix ta(a, 5, layout);
+    S21TiledMatrix tb(b, 5, layout);
+    EXPECT_TRUE(ta.mul_matrix(tb).to_matrix() == a * b);
+    EXPECT_TRUE(ta.transpose().to_matrix() == a.transpose());
+    EXPECT_ANY_THROW(ta.mul_matrix(ta));
+    EXPECT_ANY_THROW(ta.mul_matrix(S21TiledMatrix(b, 4, layout)));
+  }
+  EXPECT_EQ(S21Matrix().transpose().get_rows(), 0);
+}
+
+TEST(test_tiled, lu_decompose) {
+  // строки переставлены, чтобы понадобился выбор ведущего элемента
+  const S21Matrix base = make_test_matrix(13);
+  S21Matrix m(13, 13);
+  for (int i = 0; i < 13; ++i) {
+    for (int j = 0; j < 13; ++j) {
+      m(i, j) = base(12 - i, j);
+    }
+  }
+  const S21LuFactorization expected = m.lu_decompose();
+  S21Matrix identity(13, 13);
+  for (int i = 0; i < 13; ++i) {
+    identity(i, i) = 1.;
+  }
+  for (S21Layout layout : {S21Layout::kBlocked, S21Layout::kMorton}) {
+    for (int tile : {1, 4, 5, 16}) {
+      S21LuFactorization lu = S21TiledMatrix(m, tile, layout).lu_decompose();
+      EXPECT_FALSE(lu.singular);
+      EXPECT_EQ(lu.perm, expected.perm);
+      EXPECT_EQ(lu.sign, expected.sign);
+      expect_matrix_near(lu.lu, expected.lu, 1e-12);
+      EXPECT_NEAR(lu.determinant(), expected.determinant(),
+                  1e-12 * std::fabs(expected.determinant()));
+      expect_matrix_near(m * lu.inverse(), identity, 1e-12);
+    }
+  }
+  S21Matrix singular(7, 7);
+  std::iota(singular.begin(), singular.end(), 1.);
+  EXPECT_TRUE(S21TiledMatrix(singular, 3).lu_decompose().singular);
+  EXPECT_ANY_THROW(S21TiledMatrix(5, 4).lu_decompose());
+}
+
+TEST(test_allocation, large_allocation) {
+  const std::size_t bytes = S21Allocation::kLargeAllocation + 12345;
+  double* ptr = static_cast<double*>(S21Allocation::allocate(bytes));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(ptr[0], 0.);
+  ptr[bytes / sizeof(double) - 1] = 1.;
+  S21Allocation::deallocate(ptr, bytes);
+  void* small = S21Allocation::allocate(64);
+  ASSERT_NE(small, nullptr);
+  S21Allocation::deallocate(small, 64);
+}
+
+TEST(test_allocation, matrix_with_policy) {
+  S21AllocationPolicy policy;
+  policy.huge_pages = true;
+  policy.parallel_first_touch = true;
+  policy.numa_interleave = true;
+  S21Allocation::set_policy(policy);
+  EXPECT_TRUE(S21Allocation::get_policy().huge_pages);
+  S21Matrix m(600, 700);
+  EXPECT_EQ(m.sum(), 0.);
+  std::fill(m.begin(), m.end(), 0.5);
+  m.set_rows(800);
+  EXPECT_EQ(m(599, 699), 0.5);
+  EXPECT_EQ(m(799, 699), 0.);
+  S21Matrix copy = m;
+  copy.set_cols(5);
+  EXPECT_EQ(copy(700, 4), 0.);
+  EXPECT_DOUBLE_EQ(m.sum(), 0.5 * 600 * 700);
+  // в пределах ёмкости: старые значения не должны вернуться
+  m.set_rows(100);
+  m.set_rows(800);
+  EXPECT_EQ(m(700, 699), 0.);
+  EXPECT_DOUBLE_EQ(m.sum(), 0.5 * 100 * 700);
+  S21Allocation::set_policy(S21AllocationPolicy());
+  EXPECT_FALSE(S21Allocation::get_policy().huge_pages);
+}
+
+TEST(test_shared, publish_and_attach) {
+  const std::string name = "/s21_test_" + std::to_string(::getpid());
+  S21SharedMatrix writer = S21SharedMatrix::create(name, 3, 4);
+  S21SharedMatrix reader = S21SharedMatrix::attach(name);
+  // существующий сегмент не пересоздаётся поверх читателей
+  EXPECT_THROW(S21SharedMatrix::create(name, 3, 4), std::runtime_error);
+  EXPECT_TRUE(reader.is_read_only());
+  EXPECT_EQ(reader.get_rows(), 3);
+  EXPECT_EQ(reader.get_cols(), 4);
+  EXPECT_EQ(reader.get_version(), 0u);
+  S21Matrix m = make_test_matrix(4);
+  m.set_rows(3);
+  writer.publish(m);
+  EXPECT_EQ(reader.get_version(), 1u);
+  // читатель видит данные через своё отображение без копирования
+  EXPECT_EQ(reader(2, 3), m(2, 3));
+  EXPECT_EQ(reader.data()[5], m(1, 1));
+  EXPECT_TRUE(reader.snapshot() == m);
+  // умножение читает сегмент напрямую, без snapshot()
+  S21Matrix x = make_test_matrix(4);
+  EXPECT_TRUE(reader.mul_matrix(x) == m * x);
+  EXPECT_ANY_THROW(reader.mul_matrix(S21Matrix(3, 3)));
+  m.mul_number(2);
+  writer.publish(m);
+  EXPECT_EQ(reader.get_version(), 2u);
+  EXPECT_TRUE(reader.snapshot() == m);
+  EXPECT_ANY_THROW(reader.publish(m));
+  EXPECT_ANY_THROW(writer.publish(S21Matrix(4, 3)));
+  EXPECT_ANY_THROW(reader(3, 0));
+  S21SharedMatrix::unlink(name);
+  EXPECT_EQ(reader(0, 0), m(0, 0));
+  EXPECT_ANY_THROW(S21SharedMatrix::attach(name));
+  EXPECT_ANY_THROW(S21SharedMatrix::unlink(name));
+  EXPECT_ANY_THROW(S21SharedMatrix::create(name, 0, 1));
+}
+
+TEST(test_structured, symmetric) {
+  S21Matrix a = make_test_matrix(6);
+  a.set_cols(4);
+  S21SymmetricMatrix s = S21SymmetricMatrix::syrk(a);
+  EXPECT_EQ(s.get_storage_size(), 21u);
+  S21Matrix dense = a * a.transpose();
+  expect_matrix_near(s.to_matrix(), dense, 1e-9);
+  EXPECT_EQ(s(1, 4), s(4, 1));
+  S21Matrix b = make_test_matrix(6);
+  expect_matrix_near(s.mul_matrix(b), dense * b, 1e-9);
+  S21SymmetricMatrix spd(dense);
+  for (int i = 0; i < 6; ++i) {
+    spd(i, i) += 1.0;
+  }
+  EXPECT_NEAR(spd.determinant(), spd.to_matrix().determinant(),
+              1e-9 * std::fabs(spd.to_matrix().determinant()));
+  S21SymmetricMatrix indefinite(2);
+  indefinite(0, 1) = 1.0;
+  EXPECT_DOUBLE_EQ(indefinite.determinant(), -1.0);
+  // нулевая диагональ требует блоков 2x2, плотная копия не строится
+  S21SymmetricMatrix hollow(7);
+  for (int i = 0; i < 7; ++i) {
+    for (int j = i + 1; j < 7; ++j) {
+      hollow(i, j) = (i * 3 + j * 5) % 7 - 3.0;
+    }
+  }
+  const double hollow_det = hollow.to_matrix().determinant();
+  EXPECT_NEAR(hollow.determinant(), hollow_det, 1e-9 * std::fabs(hollow_det));
+  S21SymmetricMatrix mixed(dense);
+  for (int i = 0; i < 6; ++i) {
+    mixed(i, i) -= 100.0 * (i % 2);
+  }
+  const double mixed_det = mixed.to_matrix().determinant();
+  EXPECT_NEAR(mixed.determinant(), mixed_det, 1e-9 * std::fabs(mixed_det));
+  // ранг A * A^T не больше 4
+  EXPECT_NEAR(s.determinant(), 0.0, 1e-6);
+  EXPECT_ANY_THROW(S21SymmetricMatrix(S21Matrix(2, 3)));
+  EXPECT_ANY_THROW(s.rank_k_update(S21Matrix(5, 2)));
+  EXPECT_ANY_THROW(s(6, 0));
+}
+
+TEST(test_structured, triangular) {
+  S21Matrix a = make_test_matrix(5);
+  for (bool upper : {true, false}) {
+    S21TriangularMatrix t(a, upper);
+    EXPECT_EQ(t.get_storage_size(), 15u);
+    S21Matrix dense = t.to_matrix();
+    EXPECT_EQ(dense(upper ? 4 : 0, upper ? 0 : 4), 0.0);
+    const S21TriangularMatrix& view = t;
+    EXPECT_EQ(view(upper ? 4 : 0, upper ? 0 : 4), 0.0);
+    EXPECT_ANY_THROW(t(upper ? 4 : 0, upper ? 0 : 4) = 1.0);
+    EXPECT_NEAR(t.determinant(), dense.determinant(), 1e-9);
+    S21Matrix b = make_test_matrix(5);
+    S21Matrix x = t.solve(b);
+    expect_matrix_near(dense * x, b, 1e-9);
+    expect_matrix_near(t.mul_matrix(b), dense * b, 1e-9);
+    EXPECT_TRUE(t.transpose().to_matrix() == dense.transpose());
+    EXPECT_EQ(t.transpose().is_upper(), !upper);
+  }
+  S21TriangularMatrix singular(3);
+  EXPECT_EQ(singular.determinant(), 0.0);
+  EXPECT_ANY_THROW(singular.solve(S21Matrix(3, 1)));
+  EXPECT_ANY_THROW(singular.solve(S21Matrix(2, 1)));
+}
+
+TEST(test_structured, banded) {
+  const int n = 40;
+  S21BandedMatrix band(n, 2, 1);
+  EXPECT_EQ(band.get_storage_size(), static_cast<std::size_t>(n) * 4);
+  for (int i = 0; i < n; ++i) {
+    for (int j = std::max(0, i - 2); j <= std::min(n - 1, i + 1); ++j) {
+      // малая диагональ заставляет выбирать ведущий элемент
+      band(i, j) = (i == j) ? 0.1 : 1.0 + (i + 2 * j) % 5;
+    }
+  }
+  EXPECT_ANY_THROW(band(0, 5) = 1.0);
+  const S21BandedMatrix& view = band;
+  EXPECT_EQ(view(0, 5), 0.0);
+  S21Matrix dense = band.to_matrix();
+  EXPECT_TRUE(S21BandedMatrix(dense, 2, 1).to_matrix() == dense);
+  const double det = dense.determinant();
+  EXPECT_NEAR(band.determinant(), det, 1e-9 * std::fabs(det));
+  S21Matrix b = make_test_matrix(n);
+  b.set_cols(3);
+  expect_matrix_near(dense * band.solve(b), b, 1e-8);
+  expect_matrix_near(band.mul_matrix(b), dense * b, 1e-9);
+  S21BandedMatrix singular(4, 1, 1);
+  EXPECT_EQ(singular.determinant(), 0.0);
+  EXPECT_ANY_THROW(singular.solve(S21Matrix(4, 1)));
+  EXPECT_ANY_THROW(S21BandedMatrix(4, -1, 1));
+  EXPECT_ANY_THROW(band.mul_matrix(S21Matrix(3, 3)));
+}
+
+static S21Matrix make_signal_matrix(int rows, int cols) {
+  S21Matrix m(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      m(i, j) = 0.5 + std::sin(0.37 * i + 1.91 * j) * (1.0 + (i + j) % 3);
+    }
+  }
+  return m;
+}
+
+static double relative_error(const S21Matrix& approx, const S21Matrix& exact) {
+  S21Matrix diff = approx - exact;
+  return diff.norm_frobenius() / exact.norm_frobenius();
+}
+
+TEST(test_quantized, int8_matches_double_product) {
+  // длина свёртки не кратна ширине векторов, чтобы проверить хвосты
+  S21Matrix a = make_signal_matrix(70, 130);
+  S21Matrix b = make_signal_matrix(130, 50);
+  S21Matrix exact = a * b;
+  for (int group : {0, 32}) {
+    S21QuantizedMatrix qa(a, S21Operand::kLeft, group);
+    S21QuantizedMatrix qb(b, S21Operand::kRight, group);
+    EXPECT_LT(qa.get_storage_bytes(), 70u * 130 * sizeof(double) / 6);
+    EXPECT_LT(relative_error(qa.to_matrix(), a), 1e-2);
+    S21Matrix reference;
+    for (S21SimdLevel level :
+         {S21SimdLevel::kPortable, S21SimdLevel::kAvx2,
+          S21SimdLevel::kAvx512}) {
+      S21QuantizedMatrix::set_simd_limit(level);
+      S21Matrix product = qa.mul_matrix(qb);
+      const double error = relative_error(product, exact);
+      std::printf("int8 group %d level %d: relative error %.3e\n", group,
+                  static_cast<int>(S21QuantizedMatrix::get_simd_level()),
+                  error);
+      EXPECT_LT(error, 1e-2);
+      // целочисленные ядра обязаны совпадать побитово
+      if (level == S21SimdLevel::kPortable) {
+        reference = product;
+      } else {
+        EXPECT_TRUE(product == reference);
+      }
+    }
+  }
+  S21QuantizedMatrix::set_simd_limit(S21SimdLevel::kAvx512);
+  S21QuantizedMatrix qa(a);
+  EXPECT_ANY_THROW(qa.mul_matrix(qa));
+  EXPECT_ANY_THROW(qa.mul_matrix(S21QuantizedMatrix(a, S21Operand::kRight)));
+  EXPECT_ANY_THROW(
+      qa.mul_matrix(S21QuantizedMatrix(b, S21Operand::kRight, 16)));
+  EXPECT_ANY_THROW(S21QuantizedMatrix(a, S21Operand::kLeft, -1));
+  S21QuantizedMatrix zero(S21Matrix(2, 2));
+  EXPECT_TRUE(zero.to_matrix() == S21Matrix(2, 2));
+}
+
+TEST(test_quantized, bf16_matches_double_product) {
+  EXPECT_EQ(S21Bf16Matrix::to_float(S21Bf16Matrix::from_float(1.5f)), 1.5f);
+  EXPECT_TRUE(std::isnan(S21Bf16Matrix::to_float(
+      S21Bf16Matrix::from_float(std::nanf("")))));
+  S21Matrix a = make_signal_matrix(45, 77);
+  S21Matrix b = make_signal_matrix(77, 33);
+  S21Matrix exact = a * b;
+  S21Bf16Matrix ba(a);
+  S21Bf16Matrix bb(b, S21Operand::kRight);
+  EXPECT_EQ(ba.get_storage_bytes(), 45u * 77 * 2);
+  EXPECT_LT(relative_error(bb.to_matrix(), b), 1e-2);
+  for (S21SimdLevel level : {S21SimdLevel::kPortable, S21SimdLevel::kAvx2,
+                             S21SimdLevel::kAvx512}) {
+    S21QuantizedMatrix::set_simd_limit(level);
+    const double error = relative_error(ba.mul_matrix(bb), exact);
+    std::printf("bf16 level %d: relative error %.3e\n",
+                static_cast<int>(S21QuantizedMatrix::get_simd_level()), error);
+    EXPECT_LT(error, 1e-2);
+  }
+  S21QuantizedMatrix::set_simd_limit(S21SimdLevel::kAvx512);
+  EXPECT_ANY_THROW(ba.mul_matrix(ba));
+}
+
+namespace {
+// возвращает исходный профиль по выходе из теста
+class ProfileGuard {
+ public:
+  ProfileGuard() : saved_(S21Tuning::get()) {}
+  ~ProfileGuard() { S21Tuning::set(saved_); }
+
+ private:
+  S21TuningProfile saved_;
+};
+}  // namespace
+
+TEST(test_tuning, profile_roundtrip) {
+  ProfileGuard guard;
+  const S21TuningProfile original = S21Tuning::get();
+  S21TuningProfile heuristic = S21Tuning::heuristic();
+  EXPECT_GE(heuristic.gemm_block, 32);
+  EXPECT_LE(heuristic.gemm_block, 256);
+  EXPECT_GE(heuristic.transpose_block, 8);
+  S21TuningProfile profile;
+  profile.gemm_block = 48;
+  profile.gemm_grain = 3;
+  profile.gemm_parallel_flops = 1e300;
+  profile.transpose_block = 8;
+  profile.reduce_parallel_size = 12345;
+  profile.lu_parallel_work = 0.5;
+  S21Tuning::set(profile);
+  const std::string path = temp_path("tuning");
+  S21Tuning::save(path);
+  S21Tuning::set(original);
+  EXPECT_TRUE(S21Tuning::load(path));
+  S21TuningProfile loaded = S21Tuning::get();
+  EXPECT_EQ(loaded.gemm_block, 48);
+  EXPECT_EQ(loaded.gemm_grain, 3);
+  EXPECT_EQ(loaded.gemm_parallel_flops, 1e300);
+  EXPECT_EQ(loaded.transpose_block, 8);
+  EXPECT_EQ(loaded.reduce_parallel_size, 12345u);
+  EXPECT_EQ(loaded.lu_parallel_work, 0.5);
+  // недопустимый профиль не меняет текущий
+  std::FILE* file = std::fopen(path.c_str(), "w");
+  std::fputs("gemm_block 2\n", file);
+  std::fclose(file);
+  EXPECT_FALSE(S21Tuning::load(path));
+  EXPECT_EQ(S21Tuning::get().gemm_block, 48);
+  std::remove(path.c_str());
+  EXPECT_FALSE(S21Tuning::load(path));
+  profile.gemm_grain = 0;
+  EXPECT_ANY_THROW(S21Tuning::set(profile));
+  EXPECT_ANY_THROW(S21Tuning::save("/nonexistent/dir/profile"));
+}
+
+TEST(test_tuning, kernels_follow_profile) {
+  ProfileGuard guard;
+  S21Matrix a = make_test_matrix(70);
+  S21Matrix b = make_test_matrix(70);
+  S21Matrix product = a * b;
+  S21Matrix transposed = a.transpose();
+  const double det = a.determinant();
+  const double sum = a.sum();
+  // мелкие блоки и нулевые пороги включают все параллельные ветки
+  S21TuningProfile profile;
+  profile.gemm_block = 8;
+  profile.gemm_grain = 1;
+  profile.gemm_parallel_flops = 0.0;
+  profile.transpose_block = 3;
+  profile.reduce_parallel_size = 0;
+  profile.lu_parallel_work = 0.0;
+  S21Tuning::set(profile);
+  expect_matrix_near(a * b, product, 1e-9);
+  EXPECT_TRUE(a.transpose() == transposed);
+  EXPECT_NEAR(a.determinant(), det, 1e-9 * std::fabs(det));
+  EXPECT_NEAR(a.sum(), sum, 1e-9 * std::fabs(sum));
+}
+
+TEST(test_tuning, autotune) {
+  ProfileGuard guard;
+  const S21TuningProfile original = S21Tuning::get();
+  EXPECT_ANY_THROW(S21Tuning::autotune(8));
+  S21TuningProfile tuned = S21Tuning::autotune(32);
+  S21TuningProfile current = S21Tuning::get();
+  EXPECT_EQ(tuned.gemm_block, current.gemm_block);
+  EXPECT_EQ(tuned.transpose_block, current.transpose_block);
+  EXPECT_LE(tuned.gemm_block, 32);
+  S21Matrix a = make_test_matrix(40);
+  S21Matrix tuned_product = a * a;
+  S21Tuning::set(original);
+  expect_matrix_near(tuned_product, a * a, 1e-9);
+}
+
+TEST(test_growth, append_rows_amortized) {
+  S21Matrix m;
+  int reallocations = 0;
+  const double* data = m.data();
+  for (int i = 0; i < 1000; ++i) {
+    m.append_row({double(i), i + 0.5, -i * 1.0});
+    if (m.data() != data) {
+      ++reallocations;
+      data = m.data();
+    }
+  }
+  EXPECT_EQ(m.get_rows(), 1000);
+  EXPECT_EQ(m.get_cols(), 3);
+  EXPECT_EQ(m(999, 1), 999.5);
+  EXPECT_GE(m.capacity(), 3000u);
+  // геометрический рост: логарифмическое число перевыделений
+  EXPECT_LE(reallocations, 16);
+  const unsigned long long version = m.get_version();
+  m.append_rows(m);
+  EXPECT_EQ(m.get_rows(), 2000);
+  EXPECT_EQ(m(1999, 2), -999.0);
+  EXPECT_GT(m.get_version(), version);
+  m.shrink_to_fit();
+  EXPECT_EQ(m.capacity(), 6000u);
+  EXPECT_ANY_THROW(m.append_row({1.0, 2.0}));
+  EXPECT_ANY_THROW(m.append_rows(S21Matrix(2, 2)));
+  EXPECT_ANY_THROW(m.append_row(nullptr, 0));
+  m.append_rows(S21Matrix());
+  EXPECT_EQ(m.get_rows(), 2000);
+  // после shrink_to_fit ёмкости нет, строка-источник переезжает
+  m.append_row(m.row_data(999), 3);
+  EXPECT_EQ(m.get_rows(), 2001);
+  EXPECT_EQ(m(2000, 0), 999.0);
+  EXPECT_EQ(m(2000, 1), 999.5);
+  EXPECT_EQ(m(2000, 2), -999.0);
+}
+
+TEST(test_growth, reserve_avoids_reallocation) {
+  S21Matrix m(4, 2);
+  m(3, 1) = 7.0;
+  m.reserve(10, 8);
+  EXPECT_GE(m.capacity(), 80u);
+  const double* data = m.data();
+  m.set_cols(8);
+  m.set_rows(10);
+  const double row[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  m.set_rows(9);
+  m.append_row(row, 8);
+  EXPECT_EQ(m.data(), data);
+  EXPECT_EQ(m(3, 1), 7.0);
+  EXPECT_EQ(m(3, 7), 0.0);
+  EXPECT_EQ(m(9, 7), 8.0);
+  EXPECT_ANY_THROW(m.reserve(0, 1));
+  S21Matrix fresh;
+  fresh.reserve(3, 3);
+  EXPECT_EQ(fresh.get_rows(), 0);
+  S21Matrix block(2, 3);
+  block(1, 2) = 4.0;
+  fresh.append_rows(block);
+  EXPECT_EQ(fresh.get_cols(), 3);
+  EXPECT_EQ(fresh(1, 2), 4.0);
+}
+
+static S21Matrix make_orthonormal(int rows, int cols, int seed) {
+  S21Matrix m(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      m(i, j) = std::sin(seed + 1.3 * i + 0.7 * j * j + 0.11 * i * j);
+    }
+  }
+  return S21LowRank::qr(m).q;
+}
+
+TEST(test_low_rank, householder_qr) {
+  for (auto [rows, cols] : {std::pair{9, 5}, std::pair{4, 7}}) {
+    S21Matrix a = make_signal_matrix(rows, cols);
+    S21QrFactorization qr = S21LowRank::qr(a);
+    const int k = std::min(rows, cols);
+    EXPECT_EQ(qr.q.get_cols(), k);
+    EXPECT_EQ(qr.r.get_rows(), k);
+    expect_matrix_near(qr.q * qr.r, a, 1e-12);
+    S21Matrix identity(k, k);
+    for (int i = 0; i < k; ++i) {
+      identity(i, i) = 1.0;
+      for (int j = 0; j < i && j < cols; ++j) {
+        EXPECT_EQ(qr.r(i, j), 0.0);
+      }
+    }
+    expect_matrix_near(qr.q.transpose() * qr.q, identity, 1e-12);
+  }
+  S21Matrix zero_column(3, 2);
+  zero_column(0, 1) = 1.0;
+  expect_matrix_near(S21LowRank::qr(zero_column).q *
+                         S21LowRank::qr(zero_column).r,
+                     zero_column, 1e-15);
+  EXPECT_ANY_THROW(S21LowRank::qr(S21Matrix()));
+}
+
+TEST(test_low_rank, randomized_svd) {
+  // A = U * diag(s) * V^T с известным быстро убывающим спектром
+  const int m = 120;
+  const int n = 80;
+  S21Matrix u = make_orthonormal(m, 20, 1);
+  S21Matrix v = make_orthonormal(n, 20, 2);
+  std::vector<double> spectrum(20);
+  for (int j = 0; j < 20; ++j) {
+    spectrum[j] = std::pow(0.5, j);
+    for (int i = 0; i < m; ++i) {
+      u(i, j) *= spectrum[j];
+    }
+  }
+  S21Matrix a = u * v.transpose();
+  S21SvdFactorization svd = S21LowRank::svd(a, 5);
+  ASSERT_EQ(svd.s.size(), 5u);
+  EXPECT_EQ(svd.u.get_rows(), m);
+  EXPECT_EQ(svd.v.get_rows(), n);
+  for (int j = 0; j < 5; ++j) {
+    EXPECT_NEAR(svd.s[j], spectrum[j], 1e-10);
+  }
+  // ошибка ранга k не меньше s[k] и близка к нему
+  const double error = (a - svd.reconstruct()).norm_frobenius();
+  EXPECT_LT(error, 1.2 * spectrum[5] * std::sqrt(4.0 / 3.0));
+  S21Matrix basis = S21LowRank::range_finder(a, 20, {0, 1, 7});
+  expect_matrix_near(basis * (basis.transpose() * a), a, 1e-10);
+  S21SvdFactorization full = S21LowRank::svd(a, 20, {0, 0, 3});
+  expect_matrix_near(full.reconstruct(), a, 1e-10);
+  EXPECT_ANY_THROW(S21LowRank::svd(a, 0));
+  EXPECT_ANY_THROW(S21LowRank::svd(a, 81));
+  EXPECT_ANY_THROW(S21LowRank::range_finder(a, 3, {-1, 0, 0}));
+}
+
+TEST(test_mixed_solver, matches_direct_solve) {
+  S21Matrix a = make_signal_matrix(60, 60);
+  for (int i = 0; i < 60; ++i) {
+    a(i, i) += 10.0;
+  }
+  S21Matrix b = make_signal_matrix(60, 3);
+  S21Matrix direct = a.lu_decompose().solve(b);
+  S21MixedSolver solver(a);
+  S21Matrix x = solver.solve(b);
+  EXPECT_FALSE(solver.used_fallback());
+  EXPECT_GT(solver.get_iterations(), 0);
+  // уточнение возвращает точность double, недостижимую во float
+  S21Matrix diff = x - direct;
+  EXPECT_LT(diff.norm_max(), 1e-13 * direct.norm_max());
+  S21Matrix residual = b - a * x;
+  EXPECT_LT(residual.norm_inf(), 1e-12 * b.norm_inf());
+  EXPECT_TRUE(solver.solve(S21Matrix(60, 1)) == S21Matrix(60, 1));
+  EXPECT_ANY_THROW(solver.solve(S21Matrix(59, 1)));
+  EXPECT_ANY_THROW(S21MixedSolver(S21Matrix(2, 3)));
+  EXPECT_ANY_THROW(S21MixedSolver(a, -1));
+}
+
+TEST(test_mixed_solver, falls_back_to_double) {
+  // матрица Гильберта: число обусловленности выше 1 / eps float
+  const int n = 9;
+  S21Matrix hilbert(n, n);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      hilbert(i, j) = 1.0 / (i + j + 1);
+    }
+  }
+  S21Matrix b(n, 1);
+  std::fill(b.begin(), b.end(), 1.0);
+  S21MixedSolver solver(hilbert);
+  S21Matrix x = solver.solve(b);
+  EXPECT_TRUE(solver.used_fallback());
+  expect_matrix_near(x, hilbert.lu_decompose().solve(b), 1e-6);
+  // значения вне диапазона float
+  S21Matrix huge(2, 2);
+  huge(0, 0) = 1e40;
+  huge(1, 1) = 1e40;
+  S21Matrix rhs(2, 1);
+  rhs(0, 0) = 1e40;
+  rhs(1, 0) = 2e40;
+  S21MixedSolver huge_solver(huge);
+  S21Matrix y = huge_solver.solve(rhs);
+  EXPECT_TRUE(huge_solver.used_fallback());
+  EXPECT_DOUBLE_EQ(y(0, 0), 1.0);
+  EXPECT_DOUBLE_EQ(y(1, 0), 2.0);
+  S21MixedSolver singular(S21Matrix(3, 3));
+  EXPECT_ANY_THROW(singular.solve(S21Matrix(3, 1)));
+  EXPECT_TRUE(singular.used_fallback());
+}
+
+TEST(test_gemm, alpha_beta) {
+  S21Matrix a = make_signal_matrix(70, 50);
+  S21Matrix b = make_signal_matrix(50, 90);
+  S21Matrix c = make_signal_matrix(70, 90);
+  S21Matrix expected = a * b * 2.5 + c * -0.5;
+  S21Matrix::gemm(2.5, a, b, -0.5, c);
+  expect_matrix_near(c, expected, 1e-12);
+  // при beta == 0 старое содержимое C не читается
+  std::fill(c.begin(), c.end(), std::nan(""));
+  S21Matrix::gemm(1.0, a, b, 0.0, c);
+  expect_matrix_near(c, a * b, 1e-12);
+  // C совпадает с операндом
+  S21Matrix square = make_signal_matrix(40, 40);
+  S21Matrix product = square * square + square;
+  S21Matrix::gemm(1.0, square, square, 1.0, square);
+  expect_matrix_near(square, product, 1e-12);
+  EXPECT_ANY_THROW(S21Matrix::gemm(1.0, a, a, 0.0, c));
+  EXPECT_ANY_THROW(S21Matrix::gemm(1.0, a, b, 0.0, square));
+}
+
+TEST(test_gemm, epilogue) {
+  S21Matrix a = make_signal_matrix(30, 20);
+  S21Matrix b = make_signal_matrix(20, 25);
+  const S21Matrix product = a * b;
+  S21GemmEpilogue epilogue;
+  epilogue.bias_mode = S21BiasMode::kPerCol;
+  for (int j = 0; j < 25; ++j) {
+    epilogue.bias.push_back(j - 12.0);
+  }
+  epilogue.activation = S21Activation::kRelu;
+  epilogue.upper = 20.0;
+  S21Matrix c(30, 25);
+  S21Matrix::gemm(1.0, a, b, 0.0, c, epilogue);
+  for (int i = 0; i < 30; ++i) {
+    for (int j = 0; j < 25; ++j) {
+      const double value = std::max(product(i, j) + j - 12.0, 0.0);
+      EXPECT_NEAR(c(i, j), std::min(value, 20.0), 1e-12);
+    }
+  }
+  S21GemmEpilogue row_bias;
+  row_bias.bias_mode = S21BiasMode::kPerRow;
+  row_bias.bias.assign(30, 0.25);
+  row_bias.activation = S21Activation::kTanh;
+  S21Matrix::gemm(1.0, a, b, 0.0, c, row_bias);
+  EXPECT_NEAR(c(3, 4), std::tanh(product(3, 4) + 0.25), 1e-12);
+  S21GemmEpilogue sigmoid;
+  sigmoid.activation = S21Activation::kSigmoid;
+  S21Matrix::gemm(1.0, a, b, 0.0, c, sigmoid);
+  EXPECT_NEAR(c(7, 1), 1.0 / (1.0 + std::exp(-product(7, 1))), 1e-12);
+  row_bias.bias.pop_back();
+  EXPECT_ANY_THROW(S21Matrix::gemm(1.0, a, b, 0.0, c, row_bias));
+  S21GemmEpilogue inverted;
+  inverted.lower = 1.0;
+  inverted.upper = 0.0;
+  EXPECT_ANY_THROW(S21Matrix::gemm(1.0, a, b, 0.0, c, inverted));
+}
+
+TEST(test_kronecker, kron_and_operator) {
+  S21Matrix a = make_signal_matrix(3, 4);
+  S21Matrix b = make_signal_matrix(5, 2);
+  S21Matrix k = S21KroneckerOperator::kron(a, b);
+  ASSERT_EQ(k.get_rows(), 15);
+  ASSERT_EQ(k.get_cols(), 8);
+  for (int i = 0; i < 3; ++i) {
+    for (int kk = 0; kk < 5; ++kk) {
+      for (int j = 0; j < 4; ++j) {
+        for (int l = 0; l < 2; ++l) {
+          EXPECT_DOUBLE_EQ(k(i * 5 + kk, j * 2 + l), a(i, j) * b(kk, l));
+        }
+      }
+    }
+  }
+  S21KroneckerOperator op(a, b);
+  EXPECT_EQ(op.get_rows(), 15);
+  EXPECT_EQ(op.get_cols(), 8);
+  EXPECT_TRUE(op.to_matrix() == k);
+  S21Matrix x = make_signal_matrix(8, 3);
+  expect_matrix_near(op.mul_matrix(x), k * x, 1e-12);
+  EXPECT_ANY_THROW(op.mul_matrix(S21Matrix(7, 1)));
+  EXPECT_ANY_THROW(S21KroneckerOperator(S21Matrix(), b));
+  EXPECT_ANY_THROW(S21KroneckerOperator::kron(S21Matrix(50000, 1),
+                                              S21Matrix(50000, 1)));
+}
+
+TEST(test_kronecker, large_operator) {
+  // явная матрица заняла бы 12.8 ГБ
+  const int n = 200;
+  S21Matrix a = make_signal_matrix(n, n);
+  S21Matrix b = make_signal_matrix(n, n).transpose();
+  S21KroneckerOperator op(a, b);
+  S21Matrix x(n * n, 1);
+  x(7 * n + 11, 0) = 1.0;
+  // единичный вектор выбирает столбец (7, 11): A(i, 7) * B(k, 11)
+  S21Matrix y = op.mul_matrix(x);
+  EXPECT_NEAR(y(5 * n + 9, 0), a(5, 7) * b(9, 11), 1e-12);
+  EXPECT_NEAR(y((n - 1) * n, 0), a(n - 1, 7) * b(0, 11), 1e-12);
+}
+
+TEST(test_kronecker, block_diagonal) {
+  std::vector<S21Matrix> blocks = {make_signal_matrix(2, 3),
+                                   make_signal_matrix(4, 4),
+                                   make_signal_matrix(1, 2)};
+  S21BlockDiagonalMatrix diag(blocks);
+  EXPECT_EQ(diag.get_rows(), 7);
+  EXPECT_EQ(diag.get_cols(), 9);
+  EXPECT_EQ(diag.get_block_count(), 3);
+  S21Matrix dense = diag.to_matrix();
+  EXPECT_DOUBLE_EQ(dense(3, 4), blocks[1](1, 1));
+  EXPECT_DOUBLE_EQ(dense(0, 5), 0.0);
+  EXPECT_DOUBLE_EQ(dense(6, 8), blocks[2](0, 1));
+  S21Matrix x = make_signal_matrix(9, 2);
+  expect_matrix_near(diag.mul_matrix(x), dense * x, 1e-12);
+  EXPECT_TRUE(diag.block(2) == blocks[2]);
+  EXPECT_ANY_THROW(diag.block(3));
+  EXPECT_ANY_THROW(diag.mul_matrix(S21Matrix(7, 2)));
+  EXPECT_ANY_THROW(S21BlockDiagonalMatrix({S21Matrix()}));
+}
+
+TEST(test_compare, tolerance) {
+  S21Matrix a = make_signal_matrix(3, 3);
+  S21Matrix b(a);
+  b(1, 2) += 1e-12;
+  // по умолчанию сравнение точное
+  EXPECT_FALSE(a == b);
+  EXPECT_TRUE(a.eq_matrix(b, {1e-11, 0.0, 0}));
+  EXPECT_FALSE(a.eq_matrix(b, {1e-13, 0.0, 0}));
+  EXPECT_TRUE(a.eq_matrix(b, {0.0, 1e-11, 0}));
+  S21Matrix c(a);
+  c(0, 0) = std::nextafter(std::nextafter(a(0, 0), 10.0), 10.0);
+  EXPECT_TRUE(a.eq_matrix(c, {0.0, 0.0, 2}));
+  EXPECT_FALSE(a.eq_matrix(c, {0.0, 0.0, 1}));
+  const S21Tolerance original = S21Matrix::get_default_tolerance();
+  S21Matrix::set_default_tolerance({1e-11, 0.0, 0});
+  EXPECT_TRUE(a == b);
+  EXPECT_TRUE(a.eq_matrix(b));
+  S21Matrix::set_default_tolerance(original);
+  EXPECT_ANY_THROW(S21Matrix::set_default_tolerance({-1.0, 0.0, 0}));
+  EXPECT_ANY_THROW(S21Matrix::set_default_tolerance({0.0, std::nan(""), 0}));
+  // NaN не равен ничему, бесконечности равны себе
+  S21Matrix special(1, 2);
+  special(0, 0) = std::nan("");
+  special(0, 1) = HUGE_VAL;
+  EXPECT_FALSE(special.eq_matrix(special, {1e300, 1.0, 1u << 30}));
+  special(0, 0) = -HUGE_VAL;
+  EXPECT_TRUE(special == special);
+  S21Matrix sign(1, 1);
+  sign(0, 0) = -0.0;
+  EXPECT_TRUE(sign == S21Matrix(1, 1));
+}
+
+TEST(test_compare, first_mismatch) {
+  ProfileGuard guard;
+  const S21TuningProfile original = S21Tuning::get();
+  S21Matrix a = make_signal_matrix(300, 301);
+  EXPECT_FALSE(a.find_mismatch(a, {}));
+  EXPECT_EQ(a.find_mismatch(S21Matrix(300, 300), {}),
+            std::make_pair(-1, -1));
+  S21Matrix b(a);
+  b(299, 300) = 0.0;
+  EXPECT_EQ(b.find_mismatch(a, {}), std::make_pair(299, 300));
+  b(200, 7) = std::nan("");
+  b(123, 45) += 1e-3;
+  EXPECT_EQ(b.find_mismatch(a, {}), std::make_pair(123, 45));
+  // разница 1e-3 в пределах допуска, NaN - нет
+  EXPECT_EQ(b.find_mismatch(a, {1e-2, 0.0, 0}), std::make_pair(200, 7));
+  S21TuningProfile profile = original;
+  profile.reduce_parallel_size = 0;
+  S21Tuning::set(profile);
+  EXPECT_EQ(b.find_mismatch(a, {}), std::make_pair(123, 45));
+  EXPECT_EQ(b.find_mismatch(a, {1e-2, 0.0, 0}), std::make_pair(200, 7));
+  EXPECT_TRUE(a == S21Matrix(a));
+  EXPECT_FALSE(S21Matrix(1, 1).find_mismatch(S21Matrix(1, 1), {}));
+}
+
+TEST(test_async, mul_matrix_async) {
+  S21Matrix m1(2, 3);
+  S21Matrix m2(3, 2);
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      m1(i, j) = i + j;
+      m2(j, i) = i - j;
+    }
+  }
+  std::future<S21Matrix> result = m1.mul_matrix_async(m2);
+  EXPECT_TRUE(result.get() == m1 * m2);
+}
+
+TEST(test_async, determinant_inverse_async) {
+  S21Matrix m(2, 2);
+  m(0, 0) = 4.;
+  m(0, 1) = 7.;
+  m(1, 0) = 2.;
+  m(1, 1) = 6.;
+  std::future<double> det = m.determinant_async();
+  std::future<S21Matrix> inv = m.inverse_async();
+  m(0, 0) = 0.;  // задачи работают со снимком матрицы
+  EXPECT_DOUBLE_EQ(det.get(), 10.);
+  EXPECT_FLOAT_EQ(inv.get()(0, 0), 0.6);
+}
+
+TEST(test_async, dependency_chain) {
+  S21Matrix m(2, 2);
+  m(0, 0) = 1.;
+  m(0, 1) = 2.;
+  m(1, 0) = 3.;
+  m(1, 1) = 4.;
+  std::shared_future<S21Matrix> square = m.mul_matrix_async(m).share();
+  std::shared_future<S21Matrix> rhs = m.mul_matrix_async(m).share();
+  std::shared_future<S21Matrix> cube =
+      S21Matrix::mul_matrix_async(square, rhs).share();
+  std::future<double> det = S21Matrix::determinant_async(square);
+  std::future<S21Matrix> inv = S21Matrix::inverse_async(cube);
+  EXPECT_TRUE(cube.get() == m * m * m * m);
+  EXPECT_DOUBLE_EQ(det.get(), 4.);
+  S21Matrix identity = inv.get() * cube.get();
+  EXPECT_NEAR(identity(0, 0), 1., 1e-9);
+  EXPECT_NEAR(identity(0, 1), 0., 1e-9);
+}
+
+TEST(test_async, dependency_on_pending_promise) {
+  S21Matrix m(2, 2);
+  m(0, 0) = 1.;
+  m(0, 1) = 2.;
+  m(1, 0) = 3.;
+  m(1, 1) = 4.;
+  std::promise<S21Matrix> source;
+  std::shared_future<S21Matrix> product =
+      S21Matrix::mul_matrix_async(source.get_future().share(),
+                                  m.mul_matrix_async(m).share())
+          .share();
+  std::future<double> det = S21Matrix::determinant_async(product);
+  // зависимые задачи не занимают воркеры, пока источник не готов
+  EXPECT_EQ(det.wait_for(std::chrono::milliseconds(20)),
+            std::future_status::timeout);
+  EXPECT_TRUE(m.mul_matrix_async(m).get() == m * m);
+  source.set_value(m);
+  EXPECT_DOUBLE_EQ(det.get(), -8.);
+  EXPECT_TRUE(product.get() == m * m * m);
+  std::shared_future<S21Matrix> lazy =
+      std::async(std::launch::deferred, [m]() { return m; }).share();
+  EXPECT_THROW(S21Matrix::determinant_async(lazy), std::invalid_argument);
+}
+
+TEST(test_async, exception_async) {
+  S21Matrix m1(2, 3);
+  S21Matrix m2(2, 3);
+  std::future<S21Matrix> result = m1.mul_matrix_async(m2);
+  EXPECT_THROW(result.get(), std::invalid_argument);
+  std::future<double> det = m1.determinant_async();
+  EXPECT_THROW(det.get(), std::invalid_argument);
+}
+
 int main() {
   testing::InitGoogleTest();
   if (RUN_ALL_TESTS()) {